@@ -0,0 +1,265 @@
+#include "backjump.h"
+#include "progress.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+    uint16_t key;               // Deepest placement (cell index) of the nogood
+    uint8_t size;               // Number of placements including key (0 = empty slot)
+    uint16_t others[NOGOOD_MAX_SIZE - 1];
+} Nogood;
+
+typedef struct {
+    Nogood slots[NOGOOD_WAYS];
+    uint8_t next;               // Round-robin replacement cursor
+} NogoodBucket;
+
+typedef struct {
+    Puzzle* puzzle;
+    SolverConfig config;
+    int n;
+    int row_level[MAX_N];       // Level whose queen occupies the row (-1 = free)
+    int col_level[MAX_N];       // Level whose queen occupies the column (-1 = free)
+    int queen_cell[MAX_N];      // Cell index (row * MAX_N + col) placed at each level
+    NogoodBucket* nogoods;
+    BackjumpStats* stats;
+    SearchCounters counters;    // Nodes for the budget and the progress reporter
+} BackjumpContext;
+
+_Static_assert(MAX_N <= BACKJUMP_MAX_N, "Conflict masks need a bit for every region");
+
+static uint64_t level_bit(int level) {
+    return (uint64_t)1 << level;
+}
+
+/*
+ * Mask of all levels below the given one
+ */
+static uint64_t levels_below(int level) {
+    return level >= 64 ? ~(uint64_t)0 : level_bit(level) - 1;
+}
+
+static NogoodBucket* nogood_bucket(BackjumpContext* ctx, int cell) {
+    return &ctx->nogoods[((unsigned int)cell * 2654435761u >> 7) % NOGOOD_BUCKETS];
+}
+
+/*
+ * Earliest level whose queen rules out (row, col), or -1 if the cell is free
+ */
+static int find_culprit(const BackjumpContext* ctx, int row, int col) {
+    const Puzzle* puzzle = ctx->puzzle;
+    int n = ctx->n;
+    int culprit = -1;
+
+    if (ctx->row_level[row] >= 0) {
+        culprit = ctx->row_level[row];
+    }
+    if (ctx->col_level[col] >= 0 && (culprit < 0 || ctx->col_level[col] < culprit)) {
+        culprit = ctx->col_level[col];
+    }
+
+    for (int dr = -1; dr <= 1; dr++) {
+        for (int dc = -1; dc <= 1; dc++) {
+            int nr = row + dr;
+            int nc = col + dc;
+            if ((dr == 0 && dc == 0) || nr < 0 || nr >= n || nc < 0 || nc >= n) continue;
+
+            int level = puzzle->board[nr][nc];
+            if (level >= 0 && (culprit < 0 || level < culprit)) {
+                culprit = level;
+            }
+        }
+    }
+
+    return culprit;
+}
+
+/*
+ * Check stored nogoods ending in cell; on a hit, *reason gets the levels of
+ * the other placements and true is returned
+ */
+static bool nogood_blocks(BackjumpContext* ctx, int cell, uint64_t* reason) {
+    const Puzzle* puzzle = ctx->puzzle;
+    NogoodBucket* bucket = nogood_bucket(ctx, cell);
+
+    for (int w = 0; w < NOGOOD_WAYS; w++) {
+        const Nogood* nogood = &bucket->slots[w];
+        if (nogood->size == 0 || nogood->key != cell) continue;
+
+        uint64_t levels = 0;
+        bool all_placed = true;
+        for (int i = 0; i < nogood->size - 1; i++) {
+            int level = puzzle->board[nogood->others[i] / MAX_N][nogood->others[i] % MAX_N];
+            if (level < 0) {
+                all_placed = false;
+                break;
+            }
+            levels |= level_bit(level);
+        }
+
+        if (all_placed) {
+            *reason = levels;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/*
+ * Store the placements at the conflict levels as a nogood keyed by the deepest one
+ */
+static void nogood_record(BackjumpContext* ctx, uint64_t conflict) {
+    int size = __builtin_popcountll(conflict);
+    if (size == 0 || size > NOGOOD_MAX_SIZE) {
+        return;
+    }
+
+    int deepest = 63 - __builtin_clzll(conflict);
+    int key = ctx->queen_cell[deepest];
+    NogoodBucket* bucket = nogood_bucket(ctx, key);
+
+    Nogood* slot = &bucket->slots[bucket->next];
+    bucket->next = (uint8_t)((bucket->next + 1) % NOGOOD_WAYS);
+
+    slot->key = (uint16_t)key;
+    slot->size = (uint8_t)size;
+    int count = 0;
+    uint64_t rest = conflict & ~level_bit(deepest);
+    while (rest) {
+        int level = __builtin_ctzll(rest);
+        slot->others[count++] = (uint16_t)ctx->queen_cell[level];
+        rest &= rest - 1;
+    }
+
+    ctx->stats->nogoods_recorded++;
+}
+
+static bool should_stop(BackjumpContext* ctx) {
+    if (ctx->stats->interrupted) {
+        return true;
+    }
+    if ((ctx->config.cancel && atomic_load_explicit(ctx->config.cancel, memory_order_relaxed)) ||
+        (ctx->config.node_limit > 0 &&
+         atomic_load_explicit(&ctx->counters.nodes, memory_order_relaxed) >= ctx->config.node_limit)) {
+        ctx->stats->interrupted = true;
+        return true;
+    }
+    return false;
+}
+
+/*
+ * Returns the conflict set of the subtree rooted at this level: the earlier
+ * levels whose placements explain why it produced no (further) solutions
+ */
+static uint64_t backjump(BackjumpContext* ctx, int level) {
+    Puzzle* puzzle = ctx->puzzle;
+    int n = ctx->n;
+
+    if (level == n) {
+        if (puzzle->solution_count == 0) {
+            puzzle_save_solution(puzzle);
+        } else {
+            puzzle->solution_count++;
+        }
+        atomic_store_explicit(&ctx->counters.solutions, puzzle->solution_count, memory_order_relaxed);
+        if (ctx->config.on_solution) {
+            ctx->config.on_solution(puzzle, ctx->config.solution_context);
+        }
+        // A solution depends on every placement: force chronological backtracking
+        return levels_below(n);
+    }
+
+    if (should_stop(ctx)) {
+        return levels_below(level);
+    }
+
+    long long solutions_before = puzzle->solution_count;
+    uint64_t conflict = 0;
+    atomic_store_explicit(&ctx->counters.depth, level, memory_order_relaxed);
+
+    for (int i = 0; i < puzzle->region_size[level]; i++) {
+        int row = puzzle->region_cells_row[level][i];
+        int col = puzzle->region_cells_col[level][i];
+        int cell = row * MAX_N + col;
+
+        long long nodes = atomic_load_explicit(&ctx->counters.nodes, memory_order_relaxed);
+        atomic_store_explicit(&ctx->counters.nodes, nodes + 1, memory_order_relaxed);
+
+        int culprit = find_culprit(ctx, row, col);
+        if (culprit >= 0) {
+            conflict |= level_bit(culprit);
+            continue;
+        }
+
+        uint64_t reason;
+        if (nogood_blocks(ctx, cell, &reason)) {
+            conflict |= reason;
+            ctx->stats->nogood_prunes++;
+            continue;
+        }
+
+        // Place queen
+        puzzle->board[row][col] = level;
+        ctx->row_level[row] = level;
+        ctx->col_level[col] = level;
+        ctx->queen_cell[level] = cell;
+        atomic_store_explicit(&ctx->counters.branch[level], i, memory_order_relaxed);
+
+        uint64_t child = backjump(ctx, level + 1);
+
+        // Backtrack
+        puzzle->board[row][col] = -1;
+        ctx->row_level[row] = -1;
+        ctx->col_level[col] = -1;
+
+        if ((!ctx->config.find_all_solutions && puzzle_has_solution(puzzle)) ||
+            ctx->stats->interrupted) {
+            return levels_below(level);
+        }
+
+        // This level played no part in the failure below: jump straight past it
+        if (!(child & level_bit(level))) {
+            ctx->stats->backjumps++;
+            return child;
+        }
+        conflict |= child & ~level_bit(level);
+    }
+
+    // Only failures that produced no solution are valid nogoods
+    if (puzzle->solution_count == solutions_before) {
+        nogood_record(ctx, conflict);
+    }
+
+    return conflict;
+}
+
+void backjump_search(Puzzle* puzzle, SolverConfig config, BackjumpStats* stats) {
+    memset(stats, 0, sizeof(*stats));
+
+    BackjumpContext ctx;
+    progress_counters_reset(&ctx.counters, puzzle->solution_count);
+    ctx.puzzle = puzzle;
+    ctx.config = config;
+    ctx.n = puzzle_get_size(puzzle);
+    ctx.stats = stats;
+    for (int i = 0; i < MAX_N; i++) {
+        ctx.row_level[i] = -1;
+        ctx.col_level[i] = -1;
+        ctx.queen_cell[i] = -1;
+    }
+
+    ctx.nogoods = (NogoodBucket*)calloc(NOGOOD_BUCKETS, sizeof(NogoodBucket));
+    if (!ctx.nogoods) {
+        stats->interrupted = true;
+        return;
+    }
+
+    progress_attach(config.progress, puzzle, &ctx.counters);
+    backjump(&ctx, 0);
+    progress_detach(config.progress);
+
+    stats->nodes_explored = atomic_load_explicit(&ctx.counters.nodes, memory_order_relaxed);
+    free(ctx.nogoods);
+}
@@ -0,0 +1,27 @@
+#ifndef BACKJUMP_H
+#define BACKJUMP_H
+
+#include "puzzle.h"
+#include "solver.h"
+
+/* Conflict sets are 64-bit level masks, one bit per region, so every MAX_N board fits */
+#define BACKJUMP_MAX_N 64
+
+/* Nogood table geometry: buckets x ways, nogoods of at most NOGOOD_MAX_SIZE placements */
+#define NOGOOD_BUCKETS 1024
+#define NOGOOD_WAYS 8
+#define NOGOOD_MAX_SIZE 4
+
+/* Counters reported by a backjumping search */
+typedef struct {
+    long long nodes_explored;
+    int backjumps;              // Levels skipped by jumping past irrelevant decisions
+    int nogoods_recorded;
+    int nogood_prunes;          // Cells rejected by a stored nogood
+    bool interrupted;
+} BackjumpStats;
+
+/* Conflict-directed backjumping search over regions 0..n-1 with nogood recording */
+void backjump_search(Puzzle* puzzle, SolverConfig config, BackjumpStats* stats);
+
+#endif
@@ -0,0 +1,206 @@
+#include "batch.h"
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+/* One 16-bit mask per lane; GCC lowers the operators to vector instructions */
+typedef uint16_t BatchVec __attribute__((vector_size(BATCH_LANES * sizeof(uint16_t))));
+
+typedef struct {
+    // Search state, one lane per puzzle
+    BatchVec row;                   // Row of the next queen
+    BatchVec n;
+    BatchVec full;                  // Low n bits set
+    BatchVec cols;                  // Columns holding a queen
+    BatchVec regions;               // Regions holding a queen
+    BatchVec cand;                  // Columns of the current row still to try
+    BatchVec active;                // All ones while the lane has a puzzle
+    BatchVec placed;                // Queens placed since the last flush
+
+    // Per-row stacks, read back by comparing each lane's row with the slot
+    BatchVec stack_cand[BATCH_MAX_N];
+    BatchVec stack_queen[BATCH_MAX_N];
+    BatchVec stack_region[BATCH_MAX_N];
+
+    // Per-lane tables
+    uint16_t region_bit[BATCH_LANES][BATCH_MAX_N + 1][BATCH_MAX_N];  // Row n is padding
+    Puzzle* puzzle[BATCH_LANES];
+    int solutions[BATCH_LANES];
+} BatchLanes;
+
+// Lanes where mask is set take a, the rest keep b (a macro: vectors wider than
+// the baseline ABI's registers are not passed by value)
+#define SELECT_LANES(mask, a, b) (((a) & (mask)) | ((b) & ~(mask)))
+
+static inline bool any_lane(const BatchVec* mask) {
+    uint64_t words[sizeof(BatchVec) / sizeof(uint64_t)];
+    uint64_t any = 0;
+    memcpy(words, mask, sizeof(words));
+    for (size_t i = 0; i < sizeof(words) / sizeof(words[0]); i++) {
+        any |= words[i];
+    }
+    return any != 0;
+}
+
+/*
+ * Put a puzzle in a lane, or leave the lane idle when puzzle is NULL
+ */
+static void load_lane(BatchLanes* lanes, int lane, Puzzle* puzzle) {
+    lanes->puzzle[lane] = puzzle;
+    lanes->solutions[lane] = 0;
+    lanes->row[lane] = 0;
+    lanes->cols[lane] = 0;
+    lanes->regions[lane] = 0;
+    if (!puzzle) {
+        lanes->active[lane] = 0;
+        lanes->cand[lane] = 0;
+        return;
+    }
+
+    int n = puzzle_get_size(puzzle);
+    puzzle_reset(puzzle, n);
+    for (int row = 0; row < n; row++) {
+        for (int col = 0; col < n; col++) {
+            lanes->region_bit[lane][row][col] = (uint16_t)(1u << puzzle->regions[row][col]);
+        }
+    }
+    lanes->n[lane] = (uint16_t)n;
+    lanes->full[lane] = (uint16_t)((1u << n) - 1);
+    lanes->cand[lane] = lanes->full[lane];
+    lanes->active[lane] = 0xFFFF;
+}
+
+/*
+ * Copy the lane's queens into its puzzle as the saved solution
+ */
+static void save_lane_solution(const BatchLanes* lanes, int lane) {
+    Puzzle* puzzle = lanes->puzzle[lane];
+    int n = puzzle_get_size(puzzle);
+
+    for (int row = 0; row < n; row++) {
+        int col = __builtin_ctz(lanes->stack_queen[row][lane]);
+        memset(puzzle->solution_board[row], -1, sizeof(int) * n);
+        puzzle->solution_board[row][col] = puzzle->regions[row][col];
+    }
+    puzzle->found = true;
+}
+
+/*
+ * Next queued puzzle that fits a lane, or NULL when the queue is empty
+ */
+static Puzzle* next_puzzle(Puzzle* const* puzzles, int count, int* next) {
+    while (*next < count) {
+        Puzzle* puzzle = puzzles[(*next)++];
+        int n = puzzle_get_size(puzzle);
+        if (n >= 1 && n <= BATCH_MAX_N) {
+            return puzzle;
+        }
+    }
+    return NULL;
+}
+
+int batch_solve_many(Puzzle* const* puzzles, int count, int limit, BatchStats* stats) {
+    clock_t start = clock();
+    static _Thread_local BatchLanes lanes;
+    int next = 0;
+
+    memset(stats, 0, sizeof(*stats));
+
+    // Stack slots in use: rows of the largest board in the batch
+    int rows = 0;
+    for (int i = 0; i < count; i++) {
+        int n = puzzle_get_size(puzzles[i]);
+        if (n <= BATCH_MAX_N && n > rows) rows = n;
+    }
+
+    for (int lane = 0; lane < BATCH_LANES; lane++) {
+        load_lane(&lanes, lane, next_puzzle(puzzles, count, &next));
+    }
+    lanes.placed = (BatchVec){0};
+
+    const BatchVec zero = {0};
+    const BatchVec one = zero + 1;
+
+    while (any_lane(&lanes.active)) {
+        stats->steps++;
+
+        // Lowest untried column of each lane's row, or backtrack if none is left
+        BatchVec pick = lanes.cand & -lanes.cand;
+        BatchVec advance = (BatchVec)(pick != 0) & lanes.active;
+        BatchVec retreat = ~advance & lanes.active;
+        BatchVec exhausted = retreat & (BatchVec)(lanes.row == 0);
+        BatchVec pop = retreat & ~exhausted;
+
+        // Region of each picked cell: the only per-lane table lookup, done
+        // branch-free for every lane and masked afterwards
+        BatchVec region;
+        for (int lane = 0; lane < BATCH_LANES; lane++) {
+            region[lane] = lanes.region_bit[lane][lanes.row[lane]][__builtin_ctz(pick[lane] | 0x8000u)];
+        }
+        region &= advance;
+        lanes.cand &= ~(pick & advance);
+        BatchVec place = advance & (BatchVec)((lanes.regions & region) == 0);
+
+        // Push the placing lanes onto their row's slot
+        for (int row = 0; row < rows; row++) {
+            BatchVec slot = place & (BatchVec)(lanes.row == (uint16_t)row);
+            lanes.stack_cand[row] = SELECT_LANES(slot, lanes.cand, lanes.stack_cand[row]);
+            lanes.stack_queen[row] = SELECT_LANES(slot, pick, lanes.stack_queen[row]);
+            lanes.stack_region[row] = SELECT_LANES(slot, region, lanes.stack_region[row]);
+        }
+        lanes.cols |= pick & place;
+        lanes.regions |= region & place;
+        lanes.row += one & place;
+        lanes.placed += one & place;
+
+        BatchVec touching = (pick | (pick << 1) | (pick >> 1)) & lanes.full;
+        BatchVec next_cand = lanes.full & ~lanes.cols & ~touching;
+        lanes.cand = SELECT_LANES(place, next_cand, lanes.cand);
+
+        // Pop the retreating lanes back to the previous row's remaining columns
+        lanes.row -= one & pop;
+        BatchVec queen = zero, queen_region = zero;
+        for (int row = 0; row < rows; row++) {
+            BatchVec slot = pop & (BatchVec)(lanes.row == (uint16_t)row);
+            lanes.cand = SELECT_LANES(slot, lanes.stack_cand[row], lanes.cand);
+            queen |= lanes.stack_queen[row] & slot;
+            queen_region |= lanes.stack_region[row] & slot;
+        }
+        lanes.cols ^= queen;
+        lanes.regions ^= queen_region;
+
+        // A full row count is a solution; its next step backtracks since cand is empty
+        BatchVec solved = place & (BatchVec)(lanes.row == lanes.n);
+        BatchVec finished = exhausted;
+        if (any_lane(&solved)) {
+            for (int lane = 0; lane < BATCH_LANES; lane++) {
+                if (!solved[lane]) continue;
+                if (lanes.solutions[lane]++ == 0) {
+                    save_lane_solution(&lanes, lane);
+                }
+                if (limit > 0 && lanes.solutions[lane] >= limit) {
+                    finished[lane] = 0xFFFF;
+                }
+            }
+        }
+
+        // Hand finished lanes the next puzzle; flush the 16-bit node counters now and then
+        if (any_lane(&finished) || (stats->steps & 0x3FFF) == 0) {
+            for (int lane = 0; lane < BATCH_LANES; lane++) {
+                stats->nodes += lanes.placed[lane];
+                lanes.placed[lane] = 0;
+                if (!finished[lane]) continue;
+
+                Puzzle* puzzle = lanes.puzzle[lane];
+                puzzle->solution_count = lanes.solutions[lane];
+                stats->puzzles++;
+                stats->solved += lanes.solutions[lane] > 0;
+
+                load_lane(&lanes, lane, next_puzzle(puzzles, count, &next));
+            }
+        }
+    }
+
+    stats->time = (double)(clock() - start) / CLOCKS_PER_SEC;
+    return stats->puzzles;
+}
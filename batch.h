@@ -0,0 +1,33 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include "puzzle.h"
+
+#define BATCH_MAX_N 16      // Largest board a lane holds: one 16-bit column mask per row
+
+/* Puzzles searched side by side: one 256-bit register with AVX2, one 128-bit
+ * register on the baseline x86-64 target */
+#ifdef __AVX2__
+#define BATCH_LANES 16
+#else
+#define BATCH_LANES 8
+#endif
+
+/* Totals of one batch */
+typedef struct {
+    int puzzles;            // Puzzles searched (larger boards are skipped)
+    int solved;             // Of those, puzzles with at least one solution
+    long long nodes;        // Queens placed over all lanes
+    long long steps;        // Lockstep iterations of the whole batch
+    double time;            // Seconds
+} BatchStats;
+
+/* Search many small puzzles at once, one per lane of a vector register. Every
+ * lane places a queen or backtracks on each step; a lane whose puzzle is done
+ * takes the next one, so lanes stay busy until the queue runs out. Each puzzle
+ * ends like a solver_solve: first solution saved and solution_count set,
+ * stopping at limit solutions (0 = count all). Needs only the region ids.
+ * Returns the number of puzzles searched. */
+int batch_solve_many(Puzzle* const* puzzles, int count, int limit, BatchStats* stats);
+
+#endif
@@ -0,0 +1,521 @@
+#include "bench.h"
+#include "batch.h"
+#include "deduce.h"
+#include "engine.h"
+#include "perfcount.h"
+#include "pool.h"
+#include "puzzle.h"
+#include "region.h"
+#include "regionedit.h"
+#include "validator.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#define BENCH_BATCH 64      // Maps generated and solved per batch_solve_many call
+
+/* Totals for one board size */
+typedef struct {
+    int puzzles;
+    long long solutions;
+    long long nodes;
+    double time;
+    long long counters[PERF_COUNTER_COUNT];
+    bool counters_valid[PERF_COUNTER_COUNT];
+} BenchTotals;
+
+/*
+ * Print the counter columns of a row, or n/a for events that are unavailable
+ */
+static void print_counters(const long long* values, const bool* valid) {
+    for (int i = 0; i < PERF_COUNTER_COUNT; i++) {
+        if (valid[i]) {
+            printf(" %12lld", values[i]);
+        } else {
+            printf(" %12s", "n/a");
+        }
+    }
+}
+
+static void print_header(bool profile) {
+    printf("%4s %10s %10s %12s %10s", "n", "seed", "solutions", "nodes", "time(s)");
+    if (profile) {
+        for (int i = 0; i < PERF_COUNTER_COUNT; i++) {
+            printf(" %12s", perfcount_name((PerfCounter)i));
+        }
+    }
+    printf("\n");
+}
+
+/*
+ * Per-n summary with the derived ratios that matter for tuning
+ */
+static void print_summary(int n, const BenchTotals* totals, bool profile) {
+    printf("%4d %10s %10lld %12lld %10.4f", n, "total", totals->solutions, totals->nodes,
+           totals->time);
+    if (profile) {
+        print_counters(totals->counters, totals->counters_valid);
+    }
+    printf("\n");
+
+    if (totals->nodes > 0) {
+        printf("     avg %.1f nodes/puzzle, %.3g nodes/s", (double)totals->nodes / totals->puzzles,
+               totals->time > 0 ? totals->nodes / totals->time : 0.0);
+    }
+    if (profile) {
+        const long long* c = totals->counters;
+        const bool* ok = totals->counters_valid;
+        if (ok[PERF_CYCLES] && ok[PERF_INSTRUCTIONS] && c[PERF_CYCLES] > 0) {
+            printf(", IPC %.2f", (double)c[PERF_INSTRUCTIONS] / c[PERF_CYCLES]);
+        }
+        if (ok[PERF_CYCLES] && totals->nodes > 0) {
+            printf(", %.1f cycles/node", (double)c[PERF_CYCLES] / totals->nodes);
+        }
+        if (ok[PERF_BRANCH_MISSES] && totals->nodes > 0) {
+            printf(", %.3f br-miss/node", (double)c[PERF_BRANCH_MISSES] / totals->nodes);
+        }
+        if (ok[PERF_L1D_MISSES] && totals->nodes > 0) {
+            printf(", %.3f l1d-miss/node", (double)c[PERF_L1D_MISSES] / totals->nodes);
+        }
+    }
+    printf("\n\n");
+}
+
+/*
+ * Grade count seeded maps of size n and summarise how many need each rule
+ */
+static void grade_size(int n, const BenchConfig* config, PuzzlePool* pool) {
+    int grades[DEDUCE_RULE_COUNT] = {0};
+    int guessing = 0, unsolvable = 0, puzzles = 0;
+    long rounds = 0;
+    double time = 0.0;
+
+    for (int i = 0; i < config->count; i++) {
+        unsigned int seed = config->seed + (unsigned int)i;
+        Puzzle* puzzle = pool_checkout(pool, n);
+        if (!puzzle) {
+            continue;
+        }
+
+        region_seed(seed);
+        region_generate(puzzle, config->region_type);
+        puzzle_build_region_lists(puzzle);
+
+        DeduceResult result;
+        deduce_run(puzzle, &result);
+        printf("%4d %10u %-15s %6d %6d %10.6f\n", n, seed, deduce_grade(&result), result.rounds,
+               result.queens, result.time);
+
+        if (result.contradiction) {
+            unsolvable++;
+        } else if (!result.solved) {
+            guessing++;
+        } else {
+            grades[result.hardest < 0 ? 0 : result.hardest]++;
+        }
+        puzzles++;
+        rounds += result.rounds;
+        time += result.time;
+        pool_checkin(pool, puzzle);
+    }
+
+    // Solved maps by the hardest rule they needed
+    printf("%4d %10s", n, "total");
+    for (int rule = 0; rule < DEDUCE_RULE_COUNT; rule++) {
+        printf(" %s %d,", deduce_rule_name((DeduceRule)rule), grades[rule]);
+    }
+    printf(" needs guessing %d, unsolvable %d\n", guessing, unsolvable);
+    printf("     avg %.1f rounds/puzzle, %.1f us/puzzle\n\n",
+           puzzles > 0 ? (double)rounds / puzzles : 0.0, puzzles > 0 ? time * 1e6 / puzzles : 0.0);
+}
+
+/*
+ * Move up to edits random boundary cells into a neighbouring region, undoing
+ * any move that empties or splits a region. Returns the moves kept.
+ */
+static int edit_boundaries(Puzzle* puzzle, int edits) {
+    static const int DR[4] = {-1, 1, 0, 0};
+    static const int DC[4] = {0, 0, -1, 1};
+    int n = puzzle_get_size(puzzle);
+    RegionEditor editor;
+    int moved = 0;
+
+    region_edit_begin(&editor, puzzle);
+    for (int attempt = 0; attempt < 50 * edits && moved < edits; attempt++) {
+        int row = rand() % n, col = rand() % n, dir = rand() % 4;
+        int r = row + DR[dir], c = col + DC[dir];
+        int from = puzzle->regions[row][col];
+        if (r < 0 || r >= n || c < 0 || c >= n || puzzle->regions[r][c] == from) {
+            continue;
+        }
+        region_edit_move(&editor, row, col, puzzle->regions[r][c]);
+        if (!region_edit_valid(&editor) || !region_edit_continuous(&editor)) {
+            region_edit_move(&editor, row, col, from);
+        } else {
+            moved++;
+        }
+    }
+    return moved;
+}
+
+/*
+ * Solve each map, edit it, then re-solve it cold and warm-started from the
+ * first solution's phase
+ */
+static void warm_size(int n, const BenchConfig* config, PuzzlePool* pool) {
+    SolverConfig cold = config->solver;
+    cold.verbose = false;
+    cold.algorithm = SOLVER_BACKTRACK;
+    cold.checkpoint_path = NULL;
+    cold.resume = NULL;
+    SolverConfig warm = cold;
+    int phase[MAX_N];
+    warm.phase = phase;
+
+    int puzzles = 0, fast = 0;
+    long long cold_nodes = 0, warm_nodes = 0, kept = 0, given = 0;
+    double cold_time = 0.0, warm_time = 0.0;
+
+    for (int i = 0; i < config->count; i++) {
+        unsigned int seed = config->seed + (unsigned int)i;
+        Puzzle* puzzle = pool_checkout(pool, n);
+        if (!puzzle) {
+            continue;
+        }
+
+        region_seed(seed);
+        region_generate(puzzle, config->region_type);
+        puzzle_build_region_lists(puzzle);
+        solver_solve(puzzle, cold);
+        if (!puzzle_has_solution(puzzle)) {
+            pool_checkin(pool, puzzle);
+            continue;
+        }
+        solver_save_phase(puzzle, phase);
+
+        puzzle_reset(puzzle, n);
+        int moved = edit_boundaries(puzzle, config->warm_edits);
+
+        puzzle_reset(puzzle, n);
+        solver_solve(puzzle, cold);
+        SolverStats before = solver_get_stats(puzzle);
+        puzzle_reset(puzzle, n);
+        solver_solve(puzzle, warm);
+        SolverStats after = solver_get_stats(puzzle);
+
+        printf("%4d %10u %6d %10lld %12lld %12lld %6d/%-3d\n", n, seed, moved, after.solutions_found,
+               before.nodes_explored, after.nodes_explored, after.phase_kept, after.phase_given);
+
+        puzzles++;
+        cold_nodes += before.nodes_explored;
+        warm_nodes += after.nodes_explored;
+        cold_time += before.solve_time;
+        warm_time += after.solve_time;
+        kept += after.phase_kept;
+        given += after.phase_given;
+        fast += after.nodes_explored <= 2 * n;
+        pool_checkin(pool, puzzle);
+    }
+
+    if (puzzles > 0) {
+        printf("%4d %10s %6s %10s %12lld %12lld %6lld/%-3lld\n", n, "total", "", "", cold_nodes,
+               warm_nodes, kept, given);
+        printf("     avg %.1f cold / %.1f warm nodes, %.1f / %.1f us, %d of %d warm within 2n nodes\n\n",
+               (double)cold_nodes / puzzles, (double)warm_nodes / puzzles,
+               cold_time * 1e6 / puzzles, warm_time * 1e6 / puzzles, fast, puzzles);
+    }
+}
+
+/*
+ * Does the puzzle's saved solution satisfy every rule?
+ */
+static bool solution_valid(const Puzzle* puzzle) {
+    int n = puzzle_get_size(puzzle);
+    int columns[MAX_N];
+
+    for (int row = 0; row < n; row++) {
+        columns[row] = -1;
+        for (int col = 0; col < n; col++) {
+            if (puzzle->solution_board[row][col] >= 0) columns[row] = col;
+        }
+    }
+    return validator_verify_columns(puzzle, columns) == VERIFY_OK;
+}
+
+/*
+ * Solve the seeded maps of size n in batches of BENCH_BATCH lanes' worth, then
+ * one by one with solver_solve, and compare throughput and answers
+ */
+static void batch_size(int n, const BenchConfig* config, PuzzlePool* pool) {
+    SolverConfig solver_config = config->solver;
+    solver_config.verbose = false;
+    int limit = solver_config.find_all_solutions ? 0 : 1;
+
+    int puzzles = 0, solved = 0, invalid = 0, disagree = 0;
+    long long nodes = 0;
+    double batch_time = 0.0, solver_time = 0.0;
+
+    for (int first = 0; first < config->count; first += BENCH_BATCH) {
+        Puzzle* chunk[BENCH_BATCH];
+        int size = 0;
+        for (int i = first; i < config->count && size < BENCH_BATCH; i++) {
+            Puzzle* puzzle = pool_checkout(pool, n);
+            if (!puzzle) {
+                break;
+            }
+            region_seed(config->seed + (unsigned int)i);
+            region_generate(puzzle, config->region_type);
+            puzzle_build_region_lists(puzzle);
+            chunk[size++] = puzzle;
+        }
+
+        BatchStats stats;
+        batch_solve_many(chunk, size, limit, &stats);
+        puzzles += stats.puzzles;
+        solved += stats.solved;
+        nodes += stats.nodes;
+        batch_time += stats.time;
+
+        for (int i = 0; i < size; i++) {
+            Puzzle* puzzle = chunk[i];
+            long long batch_count = puzzle_get_solution_count(puzzle);
+            invalid += batch_count > 0 && !solution_valid(puzzle);
+
+            puzzle_reset(puzzle, n);
+            solver_solve(puzzle, solver_config);
+            SolverStats solver_stats = solver_get_stats(puzzle);
+            long long solver_count = solver_stats.solutions_found;
+            if (limit == 1 && solver_count > 1) solver_count = 1;
+            disagree += solver_count != batch_count;
+            solver_time += solver_stats.solve_time;
+            pool_checkin(pool, puzzle);
+        }
+    }
+
+    printf("%4d %10d %10d %12lld %10.4f %12.0f %10.4f %12.0f %9.2fx\n", n, puzzles, solved, nodes,
+           batch_time, batch_time > 0 ? puzzles / batch_time : 0.0, solver_time,
+           solver_time > 0 ? puzzles / solver_time : 0.0,
+           batch_time > 0 ? solver_time / batch_time : 0.0);
+    if (invalid > 0 || disagree > 0) {
+        printf("     %d invalid batch solutions, %d maps where the counts differ\n", invalid, disagree);
+    }
+}
+
+bool bench_run(const BenchConfig* config) {
+    if (config->min_n < 1 || config->max_n > MAX_N || config->min_n > config->max_n ||
+        config->count < 1) {
+        return false;
+    }
+
+    // Batches of BENCH_BATCH puzzles, reset per batch instead of reallocated
+    if (config->batch) {
+        PuzzlePool batch_pool;
+        if (config->max_n > BATCH_MAX_N || !pool_init(&batch_pool, BENCH_BATCH)) {
+            return false;
+        }
+        printf("%4s %10s %10s %12s %10s %12s %10s %12s %10s\n", "n", "maps", "solved",
+               "batch nodes", "batch(s)", "batch puz/s", "solver(s)", "solver puz/s", "speedup");
+        for (int n = config->min_n; n <= config->max_n; n++) {
+            batch_size(n, config, &batch_pool);
+        }
+        pool_release(&batch_pool);
+        return true;
+    }
+
+    // One puzzle, reset per map instead of reallocated
+    PuzzlePool puzzles;
+    PuzzlePool* pool = &puzzles;
+    if (!pool_init(pool, 1)) {
+        return false;
+    }
+
+    if (config->grade) {
+        printf("%4s %10s %-15s %6s %6s %10s\n", "n", "seed", "grade", "rounds", "queens", "time(s)");
+        for (int n = config->min_n; n <= config->max_n; n++) {
+            grade_size(n, config, pool);
+        }
+        pool_release(pool);
+        return true;
+    }
+
+    if (config->warm_edits > 0) {
+        printf("%4s %10s %6s %10s %12s %12s %10s\n", "n", "seed", "edits", "solutions",
+               "cold nodes", "warm nodes", "kept");
+        for (int n = config->min_n; n <= config->max_n; n++) {
+            warm_size(n, config, pool);
+        }
+        pool_release(pool);
+        return true;
+    }
+
+    PerfCounters counters;
+    bool profile = config->profile;
+    if (profile && !perfcount_open(&counters)) {
+        fprintf(stderr, "Warning: Hardware performance counters unavailable, "
+                        "reporting solver statistics only\n");
+        profile = false;
+    }
+
+    SolverConfig solver_config = config->solver;
+    solver_config.verbose = false;
+
+    print_header(profile);
+
+    for (int n = config->min_n; n <= config->max_n; n++) {
+        BenchTotals totals = {0};
+        for (int i = 0; i < PERF_COUNTER_COUNT; i++) {
+            totals.counters_valid[i] = true;
+        }
+
+        for (int i = 0; i < config->count; i++) {
+            unsigned int seed = config->seed + (unsigned int)i;
+            Puzzle* puzzle = pool_checkout(pool, n);
+            if (!puzzle) {
+                continue;
+            }
+
+            region_seed(seed);
+            region_generate(puzzle, config->region_type);
+            puzzle_build_region_lists(puzzle);
+
+            PerfSample sample;
+            if (profile) {
+                perfcount_start(&counters);
+            }
+            solver_solve(puzzle, solver_config);
+            if (profile) {
+                perfcount_stop(&counters, &sample);
+            }
+
+            SolverStats stats = solver_get_stats(puzzle);
+            printf("%4d %10u %10lld %12lld %10.4f", n, seed, stats.solutions_found,
+                   stats.nodes_explored, stats.solve_time);
+            if (profile) {
+                print_counters(sample.values, sample.valid);
+                for (int c = 0; c < PERF_COUNTER_COUNT; c++) {
+                    totals.counters[c] += sample.values[c];
+                    totals.counters_valid[c] = totals.counters_valid[c] && sample.valid[c];
+                }
+            }
+            printf("%s\n", stats.interrupted ? "  (interrupted)" : "");
+
+            totals.puzzles++;
+            totals.solutions += stats.solutions_found;
+            totals.nodes += stats.nodes_explored;
+            totals.time += stats.solve_time;
+
+            pool_checkin(pool, puzzle);
+        }
+
+        print_summary(n, &totals, profile);
+    }
+
+    if (profile) {
+        perfcount_close(&counters);
+    }
+    pool_release(pool);
+    return true;
+}
+
+/*
+ * Count one map with every engine, against the first engine's count
+ */
+static bool compare_map(Puzzle* puzzle, const BenchConfig* config, void** states, bool* usable,
+                        double* times) {
+    int n = puzzle_get_size(puzzle);
+    long long reference = -1;
+    bool agree = true;
+
+    for (int e = 0; e < engine_count(); e++) {
+        if (!usable[e]) {
+            printf(" %10s", "-");
+            continue;
+        }
+        EngineStats stats;
+        puzzle_reset(puzzle, n);
+        engine_call(engine_get(e), states[e], puzzle, config->solver, true, &stats);
+        times[e] += stats.time;
+        if (stats.interrupted) {
+            printf(" %9s*", "");
+            continue;
+        }
+        if (reference < 0) {
+            reference = stats.solutions;
+        } else if (stats.solutions != reference) {
+            agree = false;
+        }
+        printf(" %10.6f", stats.time);
+    }
+    printf(" %10lld%s\n", reference, agree ? "" : "  MISMATCH");
+    return agree;
+}
+
+int bench_compare(const BenchConfig* config) {
+    if (config->min_n < 1 || config->max_n > MAX_N || config->min_n > config->max_n ||
+        config->count < 1) {
+        return -1;
+    }
+
+    PuzzlePool puzzles;
+    if (!pool_init(&puzzles, 1)) {
+        return -1;
+    }
+
+    printf("%4s %10s", "n", "seed");
+    for (int e = 0; e < engine_count(); e++) {
+        printf(" %10s", engine_get(e)->name);
+    }
+    printf(" %10s\n", "solutions");
+
+    int mismatches = 0;
+    for (int n = config->min_n; n <= config->max_n; n++) {
+        void* states[ENGINE_MAX] = {NULL};
+        bool usable[ENGINE_MAX];
+        double times[ENGINE_MAX] = {0};
+        for (int e = 0; e < engine_count(); e++) {
+            const SolverEngine* engine = engine_get(e);
+            usable[e] = n <= engine->max_n && (!engine->init || engine->init(&states[e], n));
+        }
+
+        for (int i = 0; i < config->count; i++) {
+            unsigned int seed = config->seed + (unsigned int)i;
+            Puzzle* puzzle = pool_checkout(&puzzles, n);
+            if (!puzzle) {
+                continue;
+            }
+            region_seed(seed);
+            region_generate(puzzle, config->region_type);
+            puzzle_build_region_lists(puzzle);
+
+            printf("%4d %10u", n, seed);
+            mismatches += !compare_map(puzzle, config, states, usable, times);
+            pool_checkin(&puzzles, puzzle);
+        }
+
+        // Totals, then each engine's time relative to the first usable one
+        printf("%4d %10s", n, "total");
+        double baseline = 0.0;
+        for (int e = 0; e < engine_count(); e++) {
+            if (usable[e]) {
+                printf(" %10.4f", times[e]);
+                if (baseline == 0.0) baseline = times[e];
+            } else {
+                printf(" %10s", "-");
+            }
+        }
+        printf("\n%4s %10s", "", "relative");
+        for (int e = 0; e < engine_count(); e++) {
+            if (usable[e] && baseline > 0.0) {
+                printf(" %9.2fx", times[e] / baseline);
+            } else {
+                printf(" %10s", "-");
+            }
+            if (usable[e] && engine_get(e)->release) {
+                engine_get(e)->release(states[e]);
+            }
+        }
+        printf("\n\n");
+    }
+
+    pool_release(&puzzles);
+    return mismatches;
+}
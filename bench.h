@@ -0,0 +1,31 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include "solver.h"
+#include "region.h"
+
+/* Benchmark over seeded random maps */
+typedef struct {
+    int min_n;                  // Smallest board size
+    int max_n;                  // Largest board size
+    int count;                  // Maps per board size
+    unsigned int seed;          // Map i of each size uses seed + i
+    RegionType region_type;     // Generator for every map
+    bool profile;               // Wrap each solve in hardware performance counters
+    bool grade;                 // Grade each map by deduction instead of solving it
+    bool batch;                 // Solve each size's maps with batch_solve_many and with solver_solve
+    int warm_edits;             // Re-solve each map after this many boundary moves, cold and warm (0 = off)
+    SolverConfig solver;        // Configuration for every solve
+} BenchConfig;
+
+/* Solve count maps for each n in min_n..max_n with solver_solve (or grade them
+ * with deduce_run, time warm re-solves after edits, or race the batch solver), printing one row per map
+ * and a summary per n. Returns false on invalid arguments. */
+bool bench_run(const BenchConfig* config);
+
+/* Count every solution of the same seeded maps with each registered engine
+ * that accepts the size, printing per-engine times and flagging maps where the
+ * counts differ. Returns the number of such maps, or -1 on invalid arguments. */
+int bench_compare(const BenchConfig* config);
+
+#endif
@@ -0,0 +1,20 @@
+#include "bitboard.h"
+#include <string.h>
+
+void bitboard_from_puzzle(Bitboard* board, const Puzzle* puzzle) {
+    int n = puzzle->n;
+
+    board->n = n;
+    board->full = n == 32 ? 0xFFFFFFFFu : (1u << n) - 1;
+    memset(board->region_cols, 0, sizeof(board->region_cols));
+    memset(board->region_rows, 0, sizeof(board->region_rows));
+
+    for (int row = 0; row < n; row++) {
+        for (int col = 0; col < n; col++) {
+            int region = puzzle->regions[row][col];
+            board->region[row][col] = (unsigned char)region;
+            board->region_cols[region][row] |= 1u << col;
+            board->region_rows[region] |= 1u << row;
+        }
+    }
+}
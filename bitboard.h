@@ -0,0 +1,33 @@
+#ifndef BITBOARD_H
+#define BITBOARD_H
+
+#include "puzzle.h"
+#include <stdint.h>
+
+/* Column-mask view of a region map: bit c of a row mask is column c */
+typedef struct {
+    int n;
+    uint32_t full;                          // Low n bits set
+    uint32_t region_cols[MAX_N][MAX_N];     // [region][row]: the region's columns in that row
+    uint32_t region_rows[MAX_N];            // Rows each region touches
+    unsigned char region[MAX_N][MAX_N];     // Region id of each cell
+} Bitboard;
+
+/* Build the masks from a puzzle whose region ids are all in 0..n-1 */
+void bitboard_from_puzzle(Bitboard* board, const Puzzle* puzzle);
+
+/* Columns a queen in one of cols attacks in the next or previous row */
+static inline uint32_t bitboard_touching(uint32_t cols, uint32_t full) {
+    return (cols | (cols << 1) | (cols >> 1)) & full;
+}
+
+/* Lowest set column */
+static inline int bitboard_first(uint32_t cols) {
+    return __builtin_ctz(cols);
+}
+
+static inline int bitboard_count(uint32_t cols) {
+    return __builtin_popcount(cols);
+}
+
+#endif
@@ -0,0 +1,115 @@
+#include "checkpoint.h"
+#include "region.h"
+#include <stdio.h>
+#include <string.h>
+
+#define CHECKPOINT_MAGIC "QCHECK"
+
+void checkpoint_capture(Checkpoint* checkpoint, const Puzzle* puzzle, const int* path, int depth) {
+    int n = puzzle_get_size(puzzle);
+
+    checkpoint->depth = depth;
+    for (int i = 0; i < depth; i++) {
+        checkpoint->path[i] = path[i];
+    }
+    checkpoint->solutions = puzzle_get_solution_count(puzzle);
+
+    for (int row = 0; row < n; row++) {
+        checkpoint->first_solution[row] = -1;
+        for (int col = 0; col < n && puzzle_has_solution(puzzle); col++) {
+            if (puzzle->solution_board[row][col] >= 0) {
+                checkpoint->first_solution[row] = col;
+            }
+        }
+    }
+}
+
+void checkpoint_restore_solutions(const Checkpoint* checkpoint, Puzzle* puzzle) {
+    int n = puzzle_get_size(puzzle);
+
+    for (int row = 0; row < n; row++) {
+        int col = checkpoint->first_solution[row];
+        if (col >= 0) {
+            puzzle->solution_board[row][col] = puzzle->regions[row][col];
+        }
+    }
+    puzzle->found = checkpoint->solutions > 0;
+    puzzle->solution_count = checkpoint->solutions;
+}
+
+bool checkpoint_write(const char* path, const Puzzle* puzzle, const Checkpoint* checkpoint) {
+    int n = puzzle_get_size(puzzle);
+    char tmp_path[4096];
+    if (snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", path) >= (int)sizeof(tmp_path)) {
+        return false;
+    }
+
+    FILE* file = fopen(tmp_path, "w");
+    if (!file) {
+        return false;
+    }
+
+    fprintf(file, "%s 1\n", CHECKPOINT_MAGIC);
+    region_write_map(file, puzzle);
+    fprintf(file, "order %d\nfind_all %d\ndepth %d\npath",
+            (int)checkpoint->value_order, checkpoint->find_all_solutions ? 1 : 0, checkpoint->depth);
+    for (int i = 0; i < checkpoint->depth; i++) {
+        fprintf(file, " %d", checkpoint->path[i]);
+    }
+    fprintf(file, "\nsolutions %lld\nnodes %lld\nelapsed %.6f\nfirst",
+            checkpoint->solutions, checkpoint->nodes_explored, checkpoint->elapsed);
+    for (int row = 0; row < n; row++) {
+        fprintf(file, " %d", checkpoint->first_solution[row]);
+    }
+    fprintf(file, "\n");
+
+    bool ok = !ferror(file);
+    ok = (fclose(file) == 0) && ok;
+
+    // Rename last so a crash mid-write never leaves a torn checkpoint
+    return ok && rename(tmp_path, path) == 0;
+}
+
+bool checkpoint_read(const char* path, Puzzle* puzzle, Checkpoint* checkpoint) {
+    FILE* file = fopen(path, "r");
+    if (!file) {
+        return false;
+    }
+
+    memset(checkpoint, 0, sizeof(*checkpoint));
+
+    char magic[16];
+    int version, order, find_all;
+    bool ok = fscanf(file, "%15s %d", magic, &version) == 2 &&
+              strcmp(magic, CHECKPOINT_MAGIC) == 0 && version == 1 &&
+              region_read_map(file, puzzle) &&
+              fscanf(file, " order %d find_all %d depth %d path",
+                     &order, &find_all, &checkpoint->depth) == 3 &&
+              checkpoint->depth >= 0 && checkpoint->depth <= puzzle_get_size(puzzle);
+
+    for (int i = 0; ok && i < checkpoint->depth; i++) {
+        ok = fscanf(file, "%d", &checkpoint->path[i]) == 1 && checkpoint->path[i] >= 0;
+    }
+
+    ok = ok && fscanf(file, " solutions %lld nodes %lld elapsed %lf first",
+                      &checkpoint->solutions, &checkpoint->nodes_explored,
+                      &checkpoint->elapsed) == 3;
+
+    for (int row = 0; ok && row < puzzle_get_size(puzzle); row++) {
+        ok = fscanf(file, "%d", &checkpoint->first_solution[row]) == 1 &&
+             checkpoint->first_solution[row] < puzzle_get_size(puzzle);
+    }
+
+    fclose(file);
+
+    checkpoint->value_order = (ValueOrder)order;
+    checkpoint->find_all_solutions = find_all != 0;
+
+    // The path must replay on this map, or resuming would skip or recount branches
+    if (ok) {
+        puzzle_build_region_lists(puzzle);
+        ok = (order == VALUE_ORDER_RASTER || order == VALUE_ORDER_LCV) &&
+             solver_path_replays(puzzle, checkpoint->value_order, checkpoint->path, checkpoint->depth);
+    }
+    return ok;
+}
@@ -0,0 +1,33 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include "puzzle.h"
+#include "solver.h"
+
+/* Position of a solver_backtrack search, enough to continue it exactly */
+typedef struct Checkpoint {
+    ValueOrder value_order;     // Cell order the path indices refer to
+    bool find_all_solutions;
+    int depth;                  // Number of levels in path
+    int path[MAX_N];            // Position in each level's cell order
+    long long solutions;        // Solutions found before this point
+    long long nodes_explored;   // Nodes explored before this point
+    double elapsed;             // Solve time spent before this point
+    int first_solution[MAX_N];  // Column of the queen in each row of the saved solution (-1 = none)
+} Checkpoint;
+
+/* Fill path, counters and saved solution from the puzzle and the branch path to the
+ * node being entered; order, mode, nodes and elapsed are left to the caller */
+void checkpoint_capture(Checkpoint* checkpoint, const Puzzle* puzzle, const int* path, int depth);
+
+/* Put the checkpoint's solution count and saved solution back into the puzzle */
+void checkpoint_restore_solutions(const Checkpoint* checkpoint, Puzzle* puzzle);
+
+/* Atomically replace path with the region map and search position */
+bool checkpoint_write(const char* path, const Puzzle* puzzle, const Checkpoint* checkpoint);
+
+/* Load a checkpoint, re-initialising the puzzle with its region map; fails when
+ * the saved path is out of range or does not replay on that map */
+bool checkpoint_read(const char* path, Puzzle* puzzle, Checkpoint* checkpoint);
+
+#endif
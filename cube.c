@@ -0,0 +1,254 @@
+#include "cube.h"
+#include "region.h"
+#include "validator.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define CUBE_MAGIC "QCUBES"
+#define PART_MAGIC "QPART"
+#define PART_VERSION 2      // Version 1 parts did not name their cube file
+#define CUBE_MAX_WORKERS 4096
+
+/* Which cube file a part was solved from */
+typedef struct {
+    unsigned long long map_hash;
+    int depth;
+    long cubes;
+} CubeSplit;
+
+/*
+ * FNV-1a over the board size and region ids
+ */
+static unsigned long long hash_map(const Puzzle* puzzle) {
+    int n = puzzle_get_size(puzzle);
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (int i = -1; i < n * n; i++) {
+        int value = i < 0 ? n : puzzle_get_region(puzzle, i / n, i % n);
+        hash = (hash ^ (uint64_t)(unsigned int)value) * 0x100000001b3ull;
+    }
+    return hash;
+}
+
+/*
+ * Depth-first expansion of the first `depth` regions, writing one line of
+ * cell indices (row * n + col) per consistent prefix
+ */
+static long expand_prefixes(Puzzle* puzzle, int region, int depth, int* prefix, FILE* file) {
+    int n = puzzle_get_size(puzzle);
+
+    if (region == depth) {
+        for (int i = 0; i < depth; i++) {
+            fprintf(file, i + 1 < depth ? "%d " : "%d\n", prefix[i]);
+        }
+        return 1;
+    }
+
+    long count = 0;
+    for (int i = 0; i < puzzle->region_size[region]; i++) {
+        int row = puzzle->region_cells_row[region][i];
+        int col = puzzle->region_cells_col[region][i];
+
+        if (!validator_can_place(puzzle, row, col, region)) continue;
+
+        puzzle_set_cell(puzzle, row, col, region);
+        puzzle_mark_row_used(puzzle, row, true);
+        puzzle_mark_col_used(puzzle, col, true);
+        prefix[region] = row * n + col;
+
+        count += expand_prefixes(puzzle, region + 1, depth, prefix, file);
+
+        puzzle_clear_cell(puzzle, row, col);
+        puzzle_mark_row_used(puzzle, row, false);
+        puzzle_mark_col_used(puzzle, col, false);
+    }
+    return count;
+}
+
+long cube_generate(Puzzle* puzzle, int depth, const char* path) {
+    int n = puzzle_get_size(puzzle);
+    if (depth < 1 || depth > n) {
+        return -1;
+    }
+
+    FILE* file = fopen(path, "w");
+    if (!file) {
+        return -1;
+    }
+
+    fprintf(file, "%s 1\n", CUBE_MAGIC);
+    region_write_map(file, puzzle);
+    fprintf(file, "depth %d\n", depth);
+
+    int prefix[MAX_N];
+    long count = expand_prefixes(puzzle, 0, depth, prefix, file);
+
+    bool ok = !ferror(file);
+    ok = (fclose(file) == 0) && ok;
+    return ok ? count : -1;
+}
+
+/*
+ * Place a cube's prefix; false if it is not a consistent assignment for this map
+ */
+static bool place_prefix(Puzzle* puzzle, const int* prefix, int depth) {
+    int n = puzzle_get_size(puzzle);
+
+    for (int region = 0; region < depth; region++) {
+        int row = prefix[region] / n;
+        int col = prefix[region] % n;
+        if (prefix[region] < 0 || row >= n ||
+            !validator_can_place(puzzle, row, col, region)) {
+            return false;
+        }
+        puzzle_set_cell(puzzle, row, col, region);
+        puzzle_mark_row_used(puzzle, row, true);
+        puzzle_mark_col_used(puzzle, col, true);
+    }
+    return true;
+}
+
+static void clear_prefix(Puzzle* puzzle, const int* prefix, int depth) {
+    int n = puzzle_get_size(puzzle);
+
+    for (int region = 0; region < depth; region++) {
+        puzzle_clear_cell(puzzle, prefix[region] / n, prefix[region] % n);
+        puzzle_mark_row_used(puzzle, prefix[region] / n, false);
+        puzzle_mark_col_used(puzzle, prefix[region] % n, false);
+    }
+}
+
+bool cube_solve(const char* cube_path, int worker, int workers, const char* out_path,
+                SolverConfig config, CubeTotals* totals) {
+    memset(totals, 0, sizeof(*totals));
+    if (workers < 1 || workers > CUBE_MAX_WORKERS || worker < 0 || worker >= workers) {
+        return false;
+    }
+
+    FILE* file = fopen(cube_path, "r");
+    if (!file) {
+        return false;
+    }
+
+    Puzzle* puzzle = puzzle_create(1);
+    CubeSplit split = {0, 0, 0};
+    char magic[16];
+    int version, depth;
+    bool ok = puzzle &&
+              fscanf(file, "%15s %d", magic, &version) == 2 &&
+              strcmp(magic, CUBE_MAGIC) == 0 && version == 1 &&
+              region_read_map(file, puzzle) &&
+              fscanf(file, " depth %d", &depth) == 1 &&
+              depth >= 1 && depth <= puzzle_get_size(puzzle);
+
+    if (ok) {
+        puzzle_build_region_lists(puzzle);
+        config.find_all_solutions = true;
+
+        int prefix[MAX_N];
+        long long before = solver_get_stats(puzzle).nodes_explored;
+        long index = 0;
+        split.map_hash = hash_map(puzzle);
+        split.depth = depth;
+
+        while (ok) {
+            int read = 0;
+            for (int i = 0; i < depth; i++) {
+                read += fscanf(file, "%d", &prefix[i]) == 1;
+            }
+            if (read == 0) break;
+            if (read != depth) {
+                ok = false;
+                break;
+            }
+
+            if (index++ % workers != worker) continue;
+
+            if (!place_prefix(puzzle, prefix, depth)) {
+                ok = false;
+                break;
+            }
+            puzzle->solution_count = 0;
+            puzzle->found = false;
+            solver_backtrack(puzzle, depth, config);
+            clear_prefix(puzzle, prefix, depth);
+
+            totals->cubes++;
+            totals->solutions += puzzle->solution_count;
+        }
+
+        totals->nodes_explored = solver_get_stats(puzzle).nodes_explored - before;
+        split.cubes = index;
+    }
+
+    fclose(file);
+    puzzle_destroy(puzzle);
+    if (!ok) {
+        return false;
+    }
+
+    FILE* out = fopen(out_path, "w");
+    if (!out) {
+        return false;
+    }
+    fprintf(out, "%s %d\nsplit %016llx %d %ld\nworker %d %d\ncubes %ld\nsolutions %lld\nnodes %lld\n",
+            PART_MAGIC, PART_VERSION, split.map_hash, split.depth, split.cubes, worker, workers,
+            totals->cubes, totals->solutions, totals->nodes_explored);
+    ok = !ferror(out);
+    return (fclose(out) == 0) && ok;
+}
+
+bool cube_merge(char* const* part_paths, int count, CubeTotals* totals) {
+    memset(totals, 0, sizeof(*totals));
+    if (count < 1) {
+        return false;
+    }
+
+    bool seen[CUBE_MAX_WORKERS] = {false};
+    int expected_workers = -1;
+    CubeSplit expected = {0, 0, 0};
+
+    for (int i = 0; i < count; i++) {
+        FILE* file = fopen(part_paths[i], "r");
+        if (!file) {
+            return false;
+        }
+
+        char magic[16];
+        int version, worker, workers;
+        CubeTotals part;
+        CubeSplit split;
+        bool ok = fscanf(file, "%15s %d", magic, &version) == 2 &&
+                  strcmp(magic, PART_MAGIC) == 0 && version == PART_VERSION &&
+                  fscanf(file, " split %llx %d %ld", &split.map_hash, &split.depth,
+                         &split.cubes) == 3 &&
+                  fscanf(file, " worker %d %d", &worker, &workers) == 2 &&
+                  fscanf(file, " cubes %ld", &part.cubes) == 1 &&
+                  fscanf(file, " solutions %lld", &part.solutions) == 1 &&
+                  fscanf(file, " nodes %lld", &part.nodes_explored) == 1;
+        fclose(file);
+
+        // Every part must come from the same cube file and worker split, and no
+        // worker may be counted twice
+        if (!ok || workers < 1 || workers > CUBE_MAX_WORKERS || worker < 0 || worker >= workers ||
+            seen[worker]) {
+            return false;
+        }
+        if (expected_workers >= 0 &&
+            (workers != expected_workers || split.map_hash != expected.map_hash ||
+             split.depth != expected.depth || split.cubes != expected.cubes)) {
+            return false;
+        }
+        expected_workers = workers;
+        expected = split;
+        seen[worker] = true;
+
+        totals->cubes += part.cubes;
+        totals->solutions += part.solutions;
+        totals->nodes_explored += part.nodes_explored;
+    }
+
+    // All workers of the split must be present for the sum to be the full count
+    return count == expected_workers;
+}
@@ -0,0 +1,28 @@
+#ifndef CUBE_H
+#define CUBE_H
+
+#include "puzzle.h"
+#include "solver.h"
+
+/* Totals reported by a cube worker or by merging worker outputs */
+typedef struct {
+    long cubes;                 // Cubes solved
+    long long solutions;        // Solutions found inside those cubes
+    long long nodes_explored;   // Search nodes spent on them
+} CubeTotals;
+
+/* Expand regions 0..depth-1 into consistent prefix assignments and write them,
+ * together with the region map, to path. Returns the number of cubes or -1. */
+long cube_generate(Puzzle* puzzle, int depth, const char* path);
+
+/* Count the solutions of every cube whose index % workers == worker and write
+ * the partial totals to out_path, tagged with the cube file's map hash, depth
+ * and cube count */
+bool cube_solve(const char* cube_path, int worker, int workers, const char* out_path,
+                SolverConfig config, CubeTotals* totals);
+
+/* Sum the partial totals written by cube_solve; false unless every worker of
+ * one split of one cube file is present exactly once */
+bool cube_merge(char* const* part_paths, int count, CubeTotals* totals);
+
+#endif
@@ -0,0 +1,308 @@
+#include "deduce.h"
+#include "bitboard.h"
+#include <string.h>
+#include <time.h>
+
+/* Kinds of unit that hold exactly one queen */
+typedef enum {
+    UNIT_ROW,
+    UNIT_COL,
+    UNIT_REGION,
+    UNIT_KINDS
+} UnitKind;
+
+typedef struct {
+    const Puzzle* puzzle;
+    const Bitboard* board;
+    uint32_t cand[MAX_N];           // Candidate columns per row (a placed queen stays a candidate)
+    uint32_t done[UNIT_KINDS];      // Units that already have their queen
+    int column[MAX_N];
+    int queens;
+} DeduceState;
+
+static const char* RULE_NAMES[DEDUCE_RULE_COUNT] = {
+    "single", "confinement", "neighbourhood", "k-regions"
+};
+
+static const char* GRADE_NAMES[DEDUCE_RULE_COUNT] = {
+    "easy", "medium", "hard", "expert"
+};
+
+const char* deduce_rule_name(DeduceRule rule) {
+    return rule >= 0 && rule < DEDUCE_RULE_COUNT ? RULE_NAMES[rule] : "unknown";
+}
+
+const char* deduce_grade(const DeduceResult* result) {
+    if (result->contradiction) return "unsolvable";
+    if (!result->solved) return "needs guessing";
+    return result->hardest < 0 ? "easy" : GRADE_NAMES[result->hardest];
+}
+
+/*
+ * Columns of row that belong to a unit
+ */
+static uint32_t unit_cells(const DeduceState* state, UnitKind kind, int unit, int row) {
+    switch (kind) {
+        case UNIT_ROW: return unit == row ? state->board->full : 0;
+        case UNIT_COL: return 1u << unit;
+        default: return state->board->region_cols[unit][row];
+    }
+}
+
+/*
+ * For every unit of one kind, the units of another kind its candidates touch
+ */
+static void compute_spans(const DeduceState* state, UnitKind from, UnitKind to, uint32_t* span) {
+    int n = state->board->n;
+    memset(span, 0, sizeof(uint32_t) * MAX_N);
+
+    for (int row = 0; row < n; row++) {
+        uint32_t cols = state->cand[row];
+        while (cols) {
+            int col = bitboard_first(cols);
+            cols &= cols - 1;
+            int id[UNIT_KINDS] = {row, col, state->board->region[row][col]};
+            span[id[from]] |= 1u << id[to];
+        }
+    }
+}
+
+static void place_queen(DeduceState* state, int row, int col) {
+    const Bitboard* board = state->board;
+    int region = board->region[row][col];
+    uint32_t bit = 1u << col;
+    uint32_t touch = bitboard_touching(bit, board->full);
+
+    for (int r = 0; r < board->n; r++) {
+        if (r != row) {
+            state->cand[r] &= ~bit & ~board->region_cols[region][r];
+        }
+    }
+    if (row > 0) state->cand[row - 1] &= ~touch;
+    if (row + 1 < board->n) state->cand[row + 1] &= ~touch;
+    state->cand[row] = bit;
+
+    state->column[row] = col;
+    state->done[UNIT_ROW] |= 1u << row;
+    state->done[UNIT_COL] |= bit;
+    state->done[UNIT_REGION] |= 1u << region;
+    state->queens++;
+}
+
+/*
+ * Every unit still has a candidate cell
+ */
+static bool consistent(const DeduceState* state) {
+    uint32_t spans[MAX_N];
+    uint32_t all = state->board->full;
+
+    compute_spans(state, UNIT_ROW, UNIT_COL, spans);
+    uint32_t rows = 0, cols = 0, regions = 0;
+    for (int row = 0; row < state->board->n; row++) {
+        if (spans[row]) rows |= 1u << row;
+        cols |= state->cand[row];
+    }
+    compute_spans(state, UNIT_REGION, UNIT_ROW, spans);
+    for (int region = 0; region < state->board->n; region++) {
+        if (spans[region]) regions |= 1u << region;
+    }
+    return rows == all && cols == all && regions == all;
+}
+
+/*
+ * A unit without a queen that has a single candidate cell gets it
+ */
+static bool apply_singles(DeduceState* state) {
+    const Puzzle* puzzle = state->puzzle;
+    int n = state->board->n;
+    bool progress = false;
+
+    for (int row = 0; row < n; row++) {
+        if (!(state->done[UNIT_ROW] & (1u << row)) && bitboard_count(state->cand[row]) == 1) {
+            place_queen(state, row, bitboard_first(state->cand[row]));
+            progress = true;
+        }
+    }
+
+    for (int col = 0; col < n; col++) {
+        if (state->done[UNIT_COL] & (1u << col)) continue;
+        int count = 0, last = -1;
+        for (int row = 0; row < n && count < 2; row++) {
+            if (state->cand[row] & (1u << col)) {
+                count++;
+                last = row;
+            }
+        }
+        if (count == 1) {
+            place_queen(state, last, col);
+            progress = true;
+        }
+    }
+
+    for (int region = 0; region < n; region++) {
+        if (state->done[UNIT_REGION] & (1u << region)) continue;
+        int count = 0, last = -1;
+        for (int i = 0; i < puzzle->region_size[region] && count < 2; i++) {
+            int row = puzzle->region_cells_row[region][i];
+            int col = puzzle->region_cells_col[region][i];
+            if (state->cand[row] & (1u << col)) {
+                count++;
+                last = i;
+            }
+        }
+        if (count == 1) {
+            place_queen(state, puzzle->region_cells_row[region][last],
+                        puzzle->region_cells_col[region][last]);
+            progress = true;
+        }
+    }
+    return progress;
+}
+
+/*
+ * A set of k open units whose candidates lie in exactly k units of another
+ * kind owns those k queens: clear the rest of the covered units. Searches
+ * sets of size k_min..k_max, pruning once the cover grows past k.
+ */
+typedef struct {
+    DeduceState* state;
+    UnitKind from;
+    UnitKind to;
+    uint32_t span[MAX_N];
+    int k;
+    bool progress;
+} ConfineSearch;
+
+static void eliminate_outside(ConfineSearch* search, uint32_t set, uint32_t cover) {
+    DeduceState* state = search->state;
+
+    for (int row = 0; row < state->board->n; row++) {
+        uint32_t covered = 0, owned = 0;
+        for (uint32_t units = cover; units; units &= units - 1) {
+            covered |= unit_cells(state, search->to, bitboard_first(units), row);
+        }
+        for (uint32_t units = set; units; units &= units - 1) {
+            owned |= unit_cells(state, search->from, bitboard_first(units), row);
+        }
+        uint32_t remove = state->cand[row] & covered & ~owned;
+        if (remove) {
+            state->cand[row] &= ~remove;
+            search->progress = true;
+        }
+    }
+}
+
+static void confine_from(ConfineSearch* search, int next, int size, uint32_t set, uint32_t cover) {
+    if (size == search->k) {
+        if (bitboard_count(cover) == search->k) {
+            eliminate_outside(search, set, cover);
+        }
+        return;
+    }
+
+    uint32_t open = search->state->board->full & ~search->state->done[search->from];
+    for (int unit = next; unit < search->state->board->n; unit++) {
+        if (!(open & (1u << unit))) continue;
+        uint32_t grown = cover | search->span[unit];
+        if (bitboard_count(grown) <= search->k) {
+            confine_from(search, unit + 1, size + 1, set | (1u << unit), grown);
+        }
+    }
+}
+
+static bool apply_confinement(DeduceState* state, int k_min, int k_max) {
+    static const UnitKind PAIRS[][2] = {
+        {UNIT_REGION, UNIT_ROW}, {UNIT_REGION, UNIT_COL},
+        {UNIT_ROW, UNIT_REGION}, {UNIT_COL, UNIT_REGION}
+    };
+
+    ConfineSearch search;
+    search.state = state;
+    search.progress = false;
+    for (int k = k_min; k <= k_max && !search.progress; k++) {
+        for (int p = 0; p < 4; p++) {
+            search.from = PAIRS[p][0];
+            search.to = PAIRS[p][1];
+            search.k = k;
+            compute_spans(state, search.from, search.to, search.span);
+            confine_from(&search, 0, 0, 0, 0);
+        }
+    }
+    return search.progress;
+}
+
+/*
+ * Clear a cell if its queen would leave some other row, column or region
+ * without a candidate
+ */
+static bool apply_neighbourhood(DeduceState* state) {
+    const Bitboard* board = state->board;
+    int n = board->n;
+    bool progress = false;
+
+    for (int row = 0; row < n; row++) {
+        if (state->done[UNIT_ROW] & (1u << row)) continue;
+
+        uint32_t cols = state->cand[row];
+        while (cols) {
+            int col = bitboard_first(cols);
+            cols &= cols - 1;
+
+            // Candidates left if the queen went here
+            DeduceState trial = *state;
+            place_queen(&trial, row, col);
+            if (!consistent(&trial)) {
+                state->cand[row] &= ~(1u << col);
+                progress = true;
+            }
+        }
+    }
+    return progress;
+}
+
+bool deduce_run(const Puzzle* puzzle, DeduceResult* result) {
+    clock_t start = clock();
+    DeduceState state;
+    Bitboard board;
+    int n = puzzle->n;
+
+    bitboard_from_puzzle(&board, puzzle);
+    state.puzzle = puzzle;
+    state.board = &board;
+    for (int row = 0; row < n; row++) {
+        state.cand[row] = board.full;
+        state.column[row] = -1;
+    }
+    memset(state.done, 0, sizeof(state.done));
+    state.queens = 0;
+
+    memset(result, 0, sizeof(*result));
+    result->hardest = -1;
+
+    while (state.queens < n && consistent(&state)) {
+        DeduceRule rule;
+        if (apply_singles(&state)) {
+            rule = DEDUCE_SINGLE;
+        } else if (apply_confinement(&state, 1, 1)) {
+            rule = DEDUCE_CONFINEMENT;
+        } else if (apply_neighbourhood(&state)) {
+            rule = DEDUCE_NEIGHBOURHOOD;
+        } else if (apply_confinement(&state, 2, DEDUCE_MAX_K < n - 1 ? DEDUCE_MAX_K : n - 1)) {
+            rule = DEDUCE_K_REGIONS;
+        } else {
+            break;
+        }
+        result->rounds++;
+        result->uses[rule]++;
+        if ((int)rule > result->hardest) {
+            result->hardest = rule;
+        }
+    }
+
+    result->contradiction = !consistent(&state);
+    result->solved = !result->contradiction && state.queens == n;
+    result->queens = state.queens;
+    memcpy(result->columns, state.column, sizeof(result->columns));
+    result->time = (double)(clock() - start) / CLOCKS_PER_SEC;
+    return result->solved;
+}
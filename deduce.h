@@ -0,0 +1,39 @@
+#ifndef DEDUCE_H
+#define DEDUCE_H
+
+#include "puzzle.h"
+
+#define DEDUCE_MAX_K 4      // Largest region set the k-region rule looks at
+
+/* Deduction rules, easiest first */
+typedef enum {
+    DEDUCE_SINGLE,          // A row, column or region with one candidate cell left
+    DEDUCE_CONFINEMENT,     // A region inside one row or column, or the reverse
+    DEDUCE_NEIGHBOURHOOD,   // A cell whose queen would empty a row, column or region
+    DEDUCE_K_REGIONS,       // k regions spanning exactly k rows or columns, or the reverse
+    DEDUCE_RULE_COUNT
+} DeduceRule;
+
+typedef struct DeduceResult {
+    bool solved;            // Every queen placed by deduction alone
+    bool contradiction;     // Deduction emptied a row, column or region: no solution
+    int queens;             // Queens placed
+    int rounds;             // Rule applications that made progress
+    int uses[DEDUCE_RULE_COUNT];    // Rounds won by each rule
+    int hardest;            // Hardest rule needed (-1 if none)
+    int columns[MAX_N];     // Queen column per row, -1 where undecided
+    double time;            // Seconds
+} DeduceResult;
+
+/* Apply the easiest rule that makes progress until none does. Never guesses,
+ * and each round is polynomial in n. Needs the puzzle's region lists.
+ * Returns result->solved. */
+bool deduce_run(const Puzzle* puzzle, DeduceResult* result);
+
+/* Short rule name */
+const char* deduce_rule_name(DeduceRule rule);
+
+/* Difficulty from the hardest rule needed */
+const char* deduce_grade(const DeduceResult* result);
+
+#endif
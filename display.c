@@ -1,11 +1,19 @@
 #include "display.h"
+#include "estimator.h"
+#include "hints.h"
+#include "deduce.h"
+#include "sampler.h"
+#include "givens.h"
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 
 DisplayOptions display_options_default(void) {
     DisplayOptions options;
     options.show_regions = false;
     options.use_colors = false;
     options.compact = false;
+    options.format = DISPLAY_PRETTY;
     return options;
 }
 
@@ -28,103 +36,422 @@ void display_help(void) {
     printf("  -a, --all           Find all solutions\n");
     printf("  -r, --regions       Show region map\n");
     printf("  -e, --edit          Interactive region editor\n");
+    printf("  --balanced          Grow all regions together to about n cells each\n");
+    printf("  --shape SLACK ROUGH Balanced shape: percent over n allowed, roughness 0-100\n");
+    printf("  -t, --table [FILE]  Scan precomputed permutation table (n <= 10)\n");
+    printf("  --gen-table FILE    Write permutation table for n to FILE\n");
+    printf("  --order MODE        Cell order in regions: raster, lcv, random\n");
+    printf("  --order-seed N      Seed for --order random\n");
+    printf("  -p, --portfolio [N] Race N solver strategies in parallel (default 4)\n");
+    printf("  -b, --backjump      Conflict-directed backjumping with nogoods\n");
+    printf("  -i, --iterative     Explicit-stack backtracker (raster order)\n");
+    printf("  --estimate [K]      Estimate search tree size with K random probes\n");
+    printf("  --checkpoint FILE   Save the search position to FILE periodically\n");
+    printf("  --checkpoint-every S  Seconds between checkpoints (default 60)\n");
+    printf("  --resume FILE       Continue the search saved in FILE\n");
+    printf("  --progress [MS]     Report live progress every MS ms (default 1000)\n");
+    printf("  --progress-file FILE  Rewrite progress into FILE instead of stderr\n");
+    printf("  --seed N            Generate the region map from seed N\n");
+    printf("  --bench K           Solve K seeded maps and report statistics\n");
+    printf("  --bench-max N       Benchmark every size from the board size to N\n");
+    printf("  --profile           Add hardware counters to --bench (Linux perf)\n");
+    printf("  --format FMT        Board output: pretty, json, minimal\n");
+    printf("  --color             Colour cells by region (pretty)\n");
+    printf("  --compact           Unframed one-character cells (pretty)\n");
+    printf("  --dump              Print every solution as it is found\n");
+    printf("  --serve PATH        Answer solve/count/unique requests on a Unix socket\n");
+    printf("  --workers K         Worker threads for --serve (default 4)\n");
+    printf("  --verify FILE       Check map + solution records from FILE (- = stdin)\n");
+    printf("  --hints             Show the cells every solution agrees on\n");
+    printf("  --force R C         Assume a queen at row R, column C (with --hints)\n");
+    printf("  --ban R C           Assume no queen at row R, column C (with --hints)\n");
+    printf("  --engine NAME       Solve with a registered engine (listed below)\n");
+    printf("  --compare           With --bench: count every map with each engine and compare\n");
+    printf("  --batch             With --bench: solve the maps several at a time in vector lanes\n");
+    printf("                      and compare puzzles/s with one-by-one solving (n <= 16)\n");
+    printf("  --warm EDITS        With --bench: move EDITS boundary cells per map and re-solve\n");
+    printf("                      cold and warm-started from the previous solution\n");
+    printf("  --sample K          Print K uniformly random solutions, one column per row\n");
+    printf("  --sample-seed S     Seed for --sample (default 1)\n");
+    printf("  --givens            Find the fewest queens or crossed-out cells that make the\n");
+    printf("                      solution unique\n");
+    printf("  --givens-time S     Time limit for --givens in seconds (default 10, 0 = none)\n");
+    printf("  --prefer-bans       With --givens: cross out a cell instead of placing a queen\n");
+    printf("                      wherever that suffices\n");
+    printf("  --grade             Solve by deduction only and grade the map (with --bench: every map)\n");
+    printf("  --cube-gen D FILE   Split the first D regions into cubes in FILE\n");
+    printf("  --cube-solve FILE W K OUT  Count cubes W, W+K, ... and write OUT\n");
+    printf("  --cube-merge PART...       Sum partial counts from workers\n");
     printf("  -h, --help          Show this help\n\n");
 }
 
-void display_regions(const Puzzle* puzzle) {
+// Boards are rendered here and written out with one fwrite
+#define DISPLAY_FLUSH_THRESHOLD (64 * 1024)
+
+static DisplayBuffer g_output = {NULL, 0, 0};
+
+// 256-colour backgrounds cycled over region ids
+static const int REGION_COLORS[] = {
+    217, 151, 153, 229, 183, 159, 223, 194, 189, 230, 218, 158, 195, 224, 187, 252
+};
+#define REGION_COLOR_COUNT ((int)(sizeof(REGION_COLORS) / sizeof(REGION_COLORS[0])))
+
+static bool reserve(DisplayBuffer* out, size_t extra) {
+    if (out->length + extra <= out->capacity) {
+        return true;
+    }
+
+    size_t capacity = out->capacity ? out->capacity : 4096;
+    while (capacity < out->length + extra) {
+        capacity *= 2;
+    }
+    char* data = (char*)realloc(out->data, capacity);
+    if (!data) {
+        return false;
+    }
+    out->data = data;
+    out->capacity = capacity;
+    return true;
+}
+
+static void append(DisplayBuffer* out, const char* text, size_t length) {
+    if (reserve(out, length)) {
+        memcpy(out->data + out->length, text, length);
+        out->length += length;
+    }
+}
+
+static void append_str(DisplayBuffer* out, const char* text) {
+    append(out, text, strlen(text));
+}
+
+static void append_int(DisplayBuffer* out, long long value) {
+    char digits[24];
+    int length = snprintf(digits, sizeof(digits), "%lld", value);
+    append(out, digits, (size_t)length);
+}
+
+static void append_repeat(DisplayBuffer* out, const char* text, int count) {
+    for (int i = 0; i < count; i++) {
+        append_str(out, text);
+    }
+}
+
+/*
+ * Top or bottom frame line; compact boards have none
+ */
+static void append_frame(DisplayBuffer* out, int n, bool top, DisplayOptions options) {
+    if (options.compact) return;
+    append_str(out, top ? "┌" : "└");
+    append_repeat(out, "──", n);
+    append_str(out, top ? "─┐\n" : "─┘\n");
+}
+
+/*
+ * One framed row; show_ids prints region ids in empty cells
+ */
+static void append_row(DisplayBuffer* out, const Puzzle* puzzle, const int* cells, int row,
+                       bool show_ids, DisplayOptions options) {
+    static const char BASE36[] = "0123456789abcdefghijklmnopqrstuvwxyz";
     int n = puzzle_get_size(puzzle);
-    
-    printf("\nRegion Map:\n");
-    printf("┌");
-    for (int i = 0; i < n; i++) printf("──");
-    printf("─┐\n");
-    
-    for (int row = 0; row < n; row++) {
-        printf("│ ");
-        for (int col = 0; col < n; col++) {
-            printf("%d ", puzzle_get_region(puzzle, row, col));
+
+    if (!options.compact) append_str(out, "│ ");
+    for (int col = 0; col < n; col++) {
+        int region = puzzle_get_region(puzzle, row, col);
+        bool queen = cells && cells[col] >= 0;
+
+        // Cells not yet assigned to a region (interactive editor)
+        if (region < 0) {
+            append_str(out, options.compact ? "." : ". ");
+            continue;
+        }
+
+        if (options.use_colors) {
+            char color[24];
+            int length = snprintf(color, sizeof(color), "\x1b[%s30;48;5;%dm", queen ? "1;" : "",
+                                  REGION_COLORS[region % REGION_COLOR_COUNT]);
+            append(out, color, (size_t)length);
+        }
+
+        if (queen) {
+            append_str(out, "Q");
+        } else if (show_ids) {
+            if (options.compact) {
+                append(out, &BASE36[region % 36], 1);
+            } else {
+                append_int(out, region);
+            }
+        } else {
+            append_str(out, ".");
+        }
+        if (!options.compact) append_str(out, " ");
+
+        if (options.use_colors) {
+            append_str(out, "\x1b[0m");
         }
-        printf("│\n");
     }
-    
-    printf("└");
-    for (int i = 0; i < n; i++) printf("──");
-    printf("─┘\n");
+    append_str(out, options.compact ? "\n" : "│\n");
 }
 
-void display_board(const Puzzle* puzzle, DisplayOptions options) {
+static void render_region_map(DisplayBuffer* out, const Puzzle* puzzle, DisplayOptions options) {
     int n = puzzle_get_size(puzzle);
-    
+
+    append_str(out, "\nRegion Map:\n");
+    append_frame(out, n, true, options);
+    for (int row = 0; row < n; row++) {
+        append_row(out, puzzle, NULL, row, true, options);
+    }
+    append_frame(out, n, false, options);
+}
+
+/*
+ * {"n":N,"columns":[...],"regions":[[...]],"solutions":K}; regions only when
+ * requested and solutions only when >= 0
+ */
+static void render_json(DisplayBuffer* out, const Puzzle* puzzle, const int cells[][MAX_N],
+                        DisplayOptions options, long long solutions) {
+    int n = puzzle_get_size(puzzle);
+
+    append_str(out, "{\"n\":");
+    append_int(out, n);
+    append_str(out, ",\"columns\":");
+    if (cells) {
+        append_str(out, "[");
+        for (int row = 0; row < n; row++) {
+            int column = -1;
+            for (int col = 0; col < n; col++) {
+                if (cells[row][col] >= 0) column = col;
+            }
+            if (row > 0) append_str(out, ",");
+            append_int(out, column);
+        }
+        append_str(out, "]");
+    } else {
+        append_str(out, "null");
+    }
+
     if (options.show_regions) {
-        display_regions(puzzle);
-        printf("\n");
+        append_str(out, ",\"regions\":[");
+        for (int row = 0; row < n; row++) {
+            append_str(out, row > 0 ? ",[" : "[");
+            for (int col = 0; col < n; col++) {
+                if (col > 0) append_str(out, ",");
+                append_int(out, puzzle_get_region(puzzle, row, col));
+            }
+            append_str(out, "]");
+        }
+        append_str(out, "]");
+    }
+
+    if (solutions >= 0) {
+        append_str(out, ",\"solutions\":");
+        append_int(out, solutions);
+    }
+    append_str(out, "}\n");
+}
+
+/*
+ * Queen columns separated by spaces, '-' for a row without a queen
+ */
+static void render_minimal(DisplayBuffer* out, const Puzzle* puzzle, const int cells[][MAX_N]) {
+    int n = puzzle_get_size(puzzle);
+
+    if (!cells) {
+        append_str(out, "-\n");
+        return;
     }
-    
-    printf("Current Board:\n");
-    printf("┌");
-    for (int i = 0; i < n; i++) printf("──");
-    printf("─┐\n");
-    
     for (int row = 0; row < n; row++) {
-        printf("│ ");
+        int column = -1;
         for (int col = 0; col < n; col++) {
-            int cell = puzzle_get_cell(puzzle, row, col);
-            if (cell >= 0) {
-                printf("Q ");
-            } else if (options.show_regions) {
-                printf("%d ", puzzle_get_region(puzzle, row, col));
-            } else {
-                printf(". ");
-            }
+            if (cells[row][col] >= 0) column = col;
+        }
+        if (row > 0) append_str(out, " ");
+        if (column >= 0) {
+            append_int(out, column);
+        } else {
+            append_str(out, "-");
         }
-        printf("│\n");
     }
-    
-    printf("└");
-    for (int i = 0; i < n; i++) printf("──");
-    printf("─┘\n");
+    append_str(out, "\n");
 }
 
-void display_solution(const Puzzle* puzzle, DisplayOptions options) {
+void display_render_board(DisplayBuffer* out, const Puzzle* puzzle, const int cells[][MAX_N],
+                          const char* title, DisplayOptions options) {
     int n = puzzle_get_size(puzzle);
-    
-    if (!puzzle_has_solution(puzzle)) {
-        printf("No solution found!\n");
-        return;
+
+    switch (options.format) {
+        case DISPLAY_JSON:
+            render_json(out, puzzle, cells, options, -1);
+            return;
+        case DISPLAY_MINIMAL:
+            render_minimal(out, puzzle, cells);
+            return;
+        case DISPLAY_PRETTY:
+            break;
     }
-    
+
     if (options.show_regions) {
-        display_regions(puzzle);
-        printf("\n");
+        render_region_map(out, puzzle, options);
+        append_str(out, "\n");
     }
-    
-    printf("Solution:\n");
-    printf("┌");
-    for (int i = 0; i < n; i++) printf("──");
-    printf("─┐\n");
-    
+    if (title) {
+        append_str(out, title);
+        append_str(out, ":\n");
+    }
+    append_frame(out, n, true, options);
     for (int row = 0; row < n; row++) {
-        printf("│ ");
-        for (int col = 0; col < n; col++) {
-            if (puzzle->solution_board[row][col] >= 0) {
-                printf("Q ");
-            } else if (options.show_regions) {
-                printf("%d ", puzzle_get_region(puzzle, row, col));
-            } else {
-                printf(". ");
-            }
-        }
-        printf("│\n");
+        append_row(out, puzzle, cells ? cells[row] : NULL, row, options.show_regions, options);
     }
-    
-    printf("└");
-    for (int i = 0; i < n; i++) printf("──");
-    printf("─┘\n");
+    append_frame(out, n, false, options);
+}
+
+void display_buffer_free(DisplayBuffer* buffer) {
+    free(buffer->data);
+    buffer->data = NULL;
+    buffer->length = 0;
+    buffer->capacity = 0;
+}
+
+void display_flush(void) {
+    if (g_output.length > 0) {
+        fwrite(g_output.data, 1, g_output.length, stdout);
+        g_output.length = 0;
+    }
+    fflush(stdout);
+}
+
+void display_dump_solution(const Puzzle* puzzle, void* context) {
+    const DisplayOptions* options = (const DisplayOptions*)context;
+    char title[32];
+    snprintf(title, sizeof(title), "Solution %lld", puzzle_get_solution_count(puzzle));
+
+    display_render_board(&g_output, puzzle, (const int (*)[MAX_N])puzzle->board, title, *options);
+    if (g_output.length >= DISPLAY_FLUSH_THRESHOLD) {
+        display_flush();
+    }
+}
+
+void display_regions(const Puzzle* puzzle) {
+    render_region_map(&g_output, puzzle, display_options_default());
+    display_flush();
+}
+
+void display_board(const Puzzle* puzzle, DisplayOptions options) {
+    display_render_board(&g_output, puzzle, (const int (*)[MAX_N])puzzle->board,
+                         "Current Board", options);
+    display_flush();
+}
+
+void display_solution(const Puzzle* puzzle, DisplayOptions options) {
+    const int (*cells)[MAX_N] = puzzle_has_solution(puzzle)
+                                    ? (const int (*)[MAX_N])puzzle->solution_board
+                                    : NULL;
+
+    if (options.format == DISPLAY_JSON) {
+        render_json(&g_output, puzzle, cells, options, puzzle_get_solution_count(puzzle));
+    } else if (!cells && options.format == DISPLAY_PRETTY) {
+        append_str(&g_output, "No solution found!\n");
+    } else {
+        display_render_board(&g_output, puzzle, cells, "Solution", options);
+    }
+    display_flush();
 }
 
 void display_stats(const Puzzle* puzzle) {
     printf("\nStatistics:\n");
     printf("  Board Size: %dx%d\n", puzzle_get_size(puzzle), puzzle_get_size(puzzle));
-    printf("  Solutions Found: %d\n", puzzle_get_solution_count(puzzle));
+    printf("  Solutions Found: %lld\n", puzzle_get_solution_count(puzzle));
     printf("  Status: %s\n", puzzle_has_solution(puzzle) ? "Solved ✓" : "No solution");
-}
\ No newline at end of file
+}
+
+void display_estimate(const struct TreeEstimate* estimate) {
+    printf("\nSearch Tree Estimate (%d probes, %.6f seconds):\n",
+           estimate->probes, estimate->probe_time);
+    printf("  Nodes (--all): %.3g  [95%% CI %.3g - %.3g]\n",
+           estimate->nodes, estimate->nodes_ci_low, estimate->nodes_ci_high);
+    printf("  Solutions:     %.3g  [95%% CI %.3g - %.3g]\n",
+           estimate->solutions, estimate->solutions_ci_low, estimate->solutions_ci_high);
+}
+
+void display_hints(const struct HintMap* map, int n) {
+    if (!map->solvable) {
+        printf("\nNo solution under these assumptions\n");
+        return;
+    }
+
+    printf("\nHints (Q = queen, x = empty, ? = open):\n");
+    for (int row = 0; row < n; row++) {
+        printf("  ");
+        for (int col = 0; col < n; col++) {
+            char mark = map->cell[row][col] == HINT_QUEEN ? 'Q' :
+                        map->cell[row][col] == HINT_EMPTY ? 'x' : '?';
+            printf("%c%s", mark, col + 1 < n ? " " : "\n");
+        }
+    }
+    printf("  %d queens and %d empty cells decided; %ld searches, %ld cached answers\n",
+           map->queens, map->empties, map->searches, map->cache_hits);
+}
+
+void display_deduction(const Puzzle* puzzle, const struct DeduceResult* result) {
+    int n = puzzle_get_size(puzzle);
+
+    printf("\nDeduction: %s (%d rounds, %d/%d queens, %.6f seconds)\n",
+           deduce_grade(result), result->rounds, result->queens, n, result->time);
+    for (int rule = 0; rule < DEDUCE_RULE_COUNT; rule++) {
+        if (result->uses[rule] > 0) {
+            printf("  %-14s %d rounds\n", deduce_rule_name((DeduceRule)rule), result->uses[rule]);
+        }
+    }
+    printf("  Queen columns:");
+    for (int row = 0; row < n; row++) {
+        if (result->columns[row] >= 0) {
+            printf(" %d", result->columns[row]);
+        } else {
+            printf(" ?");
+        }
+    }
+    printf("\n");
+}
+
+void display_samples(struct Sampler* sampler, int count) {
+    printf("\nSampling %d of %llu solutions (%zu states counted in %.6f seconds):\n", count,
+           (unsigned long long)sampler->total, sampler->states, sampler->setup_time);
+
+    int columns[MAX_N];
+    for (int i = 0; i < count && sampler_draw(sampler, columns); i++) {
+        for (int row = 0; row < sampler->board.n; row++) {
+            printf("%d%s", columns[row], row + 1 < sampler->board.n ? " " : "\n");
+        }
+    }
+}
+
+void display_givens(const struct GivensResult* result, int n) {
+    if (!result->solvable) {
+        printf(result->timed_out ? "\nNo solution found before the time limit\n" :
+                                   "\nNo solution to single out\n");
+        return;
+    }
+
+    char cell[MAX_N][MAX_N];
+    memset(cell, '.', sizeof(cell));
+    for (int i = 0; i < result->count; i++) {
+        cell[result->givens[i].row][result->givens[i].col] = result->givens[i].queen ? 'Q' : 'x';
+    }
+
+    printf("\nGivens (Q = queen, x = crossed out), %d for a unique solution%s:\n", result->count,
+           result->optimal ? " (minimum)" :
+           result->timed_out ? " (best found before the time limit)" :
+           result->cores_full ? " (best found before the core table filled)" : "");
+    for (int row = 0; row < n; row++) {
+        printf("  ");
+        for (int col = 0; col < n; col++) {
+            printf("%c%s", cell[row][col], col + 1 < n ? " " : "\n");
+        }
+    }
+    printf("  Solution:");
+    for (int row = 0; row < n; row++) {
+        printf(" %d", result->target[row]);
+    }
+    printf("\n  %d other solutions ruled out, %ld uniqueness queries, %.6f seconds\n",
+           result->cores, result->checks, result->time);
+}
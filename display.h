@@ -2,14 +2,36 @@
 #define DISPLAY_H
 
 #include "puzzle.h"
+#include <stddef.h>
+
+struct TreeEstimate;
+struct HintMap;
+struct DeduceResult;
+struct Sampler;
+struct GivensResult;
+
+/* Output formats */
+typedef enum {
+    DISPLAY_PRETTY,         // Framed boards for terminals
+    DISPLAY_JSON,           // One JSON object per board
+    DISPLAY_MINIMAL         // One line of queen columns per board
+} DisplayFormat;
 
 /* Display options */
 typedef struct {
     bool show_regions;      // Show region numbers
     bool use_colors;        // Use ANSI colors
     bool compact;           // Compact display mode
+    DisplayFormat format;   // Output format
 } DisplayOptions;
 
+/* Growable text buffer that boards are rendered into */
+typedef struct {
+    char* data;
+    size_t length;
+    size_t capacity;
+} DisplayBuffer;
+
 /* Create default display options */
 DisplayOptions display_options_default(void);
 
@@ -19,16 +41,45 @@ void display_board(const Puzzle* puzzle, DisplayOptions options);
 /* Display the solution board */
 void display_solution(const Puzzle* puzzle, DisplayOptions options);
 
+/* Render a board (cells[row][col] >= 0 marks a queen) into out in the chosen format */
+void display_render_board(DisplayBuffer* out, const Puzzle* puzzle, const int cells[][MAX_N],
+                          const char* title, DisplayOptions options);
+
+/* Release a buffer's memory */
+void display_buffer_free(DisplayBuffer* buffer);
+
+/* Solver callback for --dump: appends the board to the shared output buffer,
+ * writing it out only once it is large. context is a const DisplayOptions*. */
+void display_dump_solution(const Puzzle* puzzle, void* context);
+
+/* Write out whatever the shared output buffer holds */
+void display_flush(void);
+
 /* Display region map */
 void display_regions(const Puzzle* puzzle);
 
 /* Display game header/banner */
 void display_banner(void);
 
-/* Display help/instructions */
+/* Display help/instructions (main lists the engines after it) */
 void display_help(void);
 
 /* Display statistics */
 void display_stats(const Puzzle* puzzle);
 
+/* Display a search tree size estimate */
+void display_estimate(const struct TreeEstimate* estimate);
+
+/* Display a hint map: Q forced queen, x ruled out, ? still open */
+void display_hints(const struct HintMap* map, int n);
+
+/* Display a deduction report and the queens it placed */
+void display_deduction(const Puzzle* puzzle, const struct DeduceResult* result);
+
+/* Draw count uniform solutions and print one column vector per line */
+void display_samples(struct Sampler* sampler, int count);
+
+/* Display a set of givens on the board: Q pre-placed queen, x crossed-out cell */
+void display_givens(const struct GivensResult* result, int n);
+
 #endif
\ No newline at end of file
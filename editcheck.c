@@ -0,0 +1,202 @@
+#include "editcheck.h"
+#include <string.h>
+
+/* State of one bounded row-by-row search */
+typedef struct {
+    EditCheck* check;
+    int n;
+    int columns[MAX_N];
+    uint32_t cols_used;
+    uint32_t regions_used;          // Assigned regions that already hold a queen
+    int wild_queens;                // Queens placed on unassigned cells
+    long nodes;
+    bool exhausted;
+} EditSearch;
+
+static int popcount32(uint32_t x) {
+    return __builtin_popcount(x);
+}
+
+/*
+ * Regions still missing a queen with no cells left in the remaining rows or
+ * free columns can only be covered by wildcard queens: those already placed, plus at most one
+ * per remaining row with an open cell
+ */
+static bool wildcards_suffice(const EditSearch* search, int row) {
+    const EditCheck* check = search->check;
+    uint32_t remaining = (search->n == 32 ? 0xFFFFFFFFu : (1u << search->n) - 1) &
+                         ~((1u << row) - 1);
+    int stranded = 0;
+
+    for (int region = 0; region < search->n; region++) {
+        if (!(search->regions_used & (1u << region)) &&
+            (!(check->region_rows[region] & remaining) ||
+             !(check->region_cols[region] & ~search->cols_used))) {
+            stranded++;
+        }
+    }
+    return stranded <= search->wild_queens + popcount32(check->wild_rows & remaining);
+}
+
+/*
+ * Returns true when the search should stop: two placements found or budget spent
+ */
+static bool search_rows(EditSearch* search, int row) {
+    EditCheck* check = search->check;
+    const Puzzle* puzzle = check->puzzle;
+    int n = search->n;
+
+    if (++search->nodes > check->node_budget) {
+        search->exhausted = true;
+        return true;
+    }
+
+    if (row == n) {
+        memcpy(check->witness[check->witnesses], search->columns, sizeof(search->columns));
+        check->witnesses++;
+        return check->witnesses >= 2;
+    }
+
+    if (!wildcards_suffice(search, row)) {
+        return false;
+    }
+
+    int prev = row > 0 ? search->columns[row - 1] : -2;
+    for (int col = 0; col < n; col++) {
+        if ((search->cols_used & (1u << col)) || (col >= prev - 1 && col <= prev + 1)) {
+            continue;
+        }
+
+        int region = puzzle->regions[row][col];
+        uint32_t region_bit = region >= 0 ? 1u << region : 0;
+        if (search->regions_used & region_bit) {
+            continue;
+        }
+
+        search->columns[row] = col;
+        search->cols_used |= 1u << col;
+        search->regions_used |= region_bit;
+        search->wild_queens += region < 0;
+        bool stop = search_rows(search, row + 1);
+        search->cols_used &= ~(1u << col);
+        search->regions_used &= ~region_bit;
+        search->wild_queens -= region < 0;
+        if (stop) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/*
+ * Does a cached placement still fit after (row, col) was assigned?
+ */
+static bool witness_survives(const EditCheck* check, const int* columns, int row, int col) {
+    const Puzzle* puzzle = check->puzzle;
+    if (columns[row] != col) {
+        return true;
+    }
+
+    int region = puzzle->regions[row][col];
+    for (int r = 0; r < puzzle->n; r++) {
+        if (r != row && puzzle->regions[r][columns[r]] == region) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static EditCheckStatus run_check(EditCheck* check) {
+    check->nodes = 0;
+    if (check->unsat) {
+        return check->status = EDITCHECK_UNSAT;
+    }
+    if (check->witnesses >= 2) {
+        return check->status = EDITCHECK_MULTIPLE;
+    }
+
+    EditSearch search;
+    memset(&search, 0, sizeof(search));
+    search.check = check;
+    search.n = check->puzzle->n;
+
+    check->witnesses = 0;
+    search_rows(&search, 0);
+    check->nodes = search.nodes;
+
+    if (check->witnesses >= 2) {
+        check->status = EDITCHECK_MULTIPLE;
+    } else if (search.exhausted) {
+        check->status = EDITCHECK_UNKNOWN;
+    } else if (check->witnesses == 1) {
+        check->status = EDITCHECK_UNIQUE;
+    } else {
+        check->unsat = true;
+        check->status = EDITCHECK_UNSAT;
+    }
+    return check->status;
+}
+
+void editcheck_init(EditCheck* check, const Puzzle* puzzle, long node_budget) {
+    int n = puzzle->n;
+
+    check->puzzle = puzzle;
+    check->wild_rows = 0;
+    check->witnesses = 0;
+    check->unsat = false;
+    check->node_budget = node_budget;
+    for (int region = 0; region < MAX_N; region++) {
+        check->region_rows[region] = 0;
+        check->region_cols[region] = 0;
+    }
+
+    for (int row = 0; row < n; row++) {
+        check->wild_in_row[row] = 0;
+        for (int col = 0; col < n; col++) {
+            int region = puzzle->regions[row][col];
+            if (region < 0) {
+                check->wild_in_row[row]++;
+                check->wild_rows |= 1u << row;
+            } else {
+                check->region_rows[region] |= 1u << row;
+                check->region_cols[region] |= 1u << col;
+            }
+        }
+    }
+
+    run_check(check);
+}
+
+EditCheckStatus editcheck_assign(EditCheck* check, int row, int col) {
+    int region = check->puzzle->regions[row][col];
+
+    check->region_rows[region] |= 1u << row;
+    check->region_cols[region] |= 1u << col;
+    if (--check->wild_in_row[row] == 0) {
+        check->wild_rows &= ~(1u << row);
+    }
+
+    // Keep the cached placements the assignment did not break
+    int kept = 0;
+    for (int i = 0; i < check->witnesses; i++) {
+        if (witness_survives(check, check->witness[i], row, col)) {
+            if (kept != i) {
+                memcpy(check->witness[kept], check->witness[i], sizeof(check->witness[i]));
+            }
+            kept++;
+        }
+    }
+    check->witnesses = kept;
+
+    return run_check(check);
+}
+
+const char* editcheck_describe(const EditCheck* check) {
+    switch (check->status) {
+        case EDITCHECK_UNSAT: return "unsat";
+        case EDITCHECK_UNIQUE: return "unique";
+        case EDITCHECK_MULTIPLE: return "2+ solutions";
+        case EDITCHECK_UNKNOWN: return "unknown (search budget reached)";
+    }
+    return "?";
+}
@@ -0,0 +1,42 @@
+#ifndef EDITCHECK_H
+#define EDITCHECK_H
+
+#include "puzzle.h"
+#include <stdint.h>
+
+/* Solvability of a partially assigned region map */
+typedef enum {
+    EDITCHECK_UNSAT,        // No queen placement fits, whatever the open cells become
+    EDITCHECK_UNIQUE,       // Exactly one placement
+    EDITCHECK_MULTIPLE,     // At least two placements
+    EDITCHECK_UNKNOWN       // Node budget ran out first
+} EditCheckStatus;
+
+/* Incremental checker for a map being built cell by cell. Unassigned cells
+ * (region -1) are wildcards: a queen there can take any region still missing
+ * one. Assignments only remove placements, so unsat is final and cached
+ * placements that survive an assignment avoid a new search. */
+typedef struct {
+    const Puzzle* puzzle;
+    uint32_t region_rows[MAX_N];    // Rows holding cells of each region
+    uint32_t region_cols[MAX_N];    // Columns holding cells of each region
+    uint32_t wild_rows;             // Rows holding unassigned cells
+    int wild_in_row[MAX_N];
+    int witness[2][MAX_N];          // Cached placements, one column per row
+    int witnesses;                  // Cached placements still valid (0-2)
+    bool unsat;
+    long node_budget;               // Search nodes allowed per check
+    long nodes;                     // Nodes used by the last search (0 = answered from cache)
+    EditCheckStatus status;
+} EditCheck;
+
+/* Scan the map and run the first check */
+void editcheck_init(EditCheck* check, const Puzzle* puzzle, long node_budget);
+
+/* Update after puzzle->regions[row][col] changed from -1 to a region, and re-check */
+EditCheckStatus editcheck_assign(EditCheck* check, int row, int col);
+
+/* Short status text such as "unique" or "2+ solutions" */
+const char* editcheck_describe(const EditCheck* check);
+
+#endif
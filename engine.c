@@ -0,0 +1,200 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "engine.h"
+#include "permtable.h"
+#include "portfolio.h"
+#include "sampler.h"
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define ENGINE_PORTFOLIO_THREADS 4
+
+static double seconds_now(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec + (double)now.tv_nsec / 1e9;
+}
+
+/*
+ * solver_solve with a fixed algorithm, for the backtracking engines
+ */
+static bool run_solver(Puzzle* puzzle, SolverConfig config, SolverAlgorithm algorithm,
+                       EngineStats* stats) {
+    double start = seconds_now();
+    config.algorithm = algorithm;
+    bool solved = solver_solve(puzzle, config);
+
+    SolverStats solver_stats = solver_get_stats(puzzle);
+    stats->solutions = puzzle_get_solution_count(puzzle);
+    stats->nodes = solver_stats.nodes_explored;
+    stats->interrupted = solver_stats.interrupted;
+    stats->time = seconds_now() - start;
+    return solved;
+}
+
+static bool backtrack_solve(void* state, Puzzle* puzzle, SolverConfig config, EngineStats* stats) {
+    (void)state;
+    return run_solver(puzzle, config, SOLVER_BACKTRACK, stats);
+}
+
+static bool backjump_solve(void* state, Puzzle* puzzle, SolverConfig config, EngineStats* stats) {
+    (void)state;
+    config.value_order = VALUE_ORDER_RASTER;
+    return run_solver(puzzle, config, SOLVER_BACKJUMP, stats);
+}
+
+static bool iterative_solve(void* state, Puzzle* puzzle, SolverConfig config, EngineStats* stats) {
+    (void)state;
+    config.value_order = VALUE_ORDER_RASTER;
+    return run_solver(puzzle, config, SOLVER_ITERATIVE, stats);
+}
+
+static bool portfolio_engine_solve(void* state, Puzzle* puzzle, SolverConfig config,
+                                   EngineStats* stats) {
+    (void)state;
+    double start = seconds_now();
+    PortfolioResult result;
+    bool solved = portfolio_solve(puzzle, config, ENGINE_PORTFOLIO_THREADS, &result);
+
+    stats->solutions = puzzle_get_solution_count(puzzle);
+    stats->nodes = result.nodes_explored;
+    stats->interrupted = result.winner < 0;
+    stats->time = seconds_now() - start;
+    return solved;
+}
+
+static bool table_init(void** state, int n) {
+    PermTable* table = (PermTable*)malloc(sizeof(PermTable));
+    if (!table || !permtable_build(table, n)) {
+        free(table);
+        return false;
+    }
+    *state = table;
+    return true;
+}
+
+static void table_release(void* state) {
+    permtable_release((PermTable*)state);
+    free(state);
+}
+
+static bool table_solve(void* state, Puzzle* puzzle, SolverConfig config, EngineStats* stats) {
+    double start = seconds_now();
+    bool solved = permtable_solve(puzzle, (const PermTable*)state, config);
+
+    stats->solutions = puzzle_get_solution_count(puzzle);
+    stats->nodes = -1;
+    stats->interrupted = false;
+    stats->time = seconds_now() - start;
+    return solved;
+}
+
+#define ENGINE_SAMPLER_MAX_N 18     // Larger maps usually outgrow the sampler's memo
+
+/*
+ * Count every state once; solutions come from the table instead of a search
+ */
+static bool sampler_run(Puzzle* puzzle, bool all, EngineStats* stats) {
+    double start = seconds_now();
+    Sampler sampler;
+    bool counted = sampler_init(&sampler, puzzle, 1);
+    int columns[MAX_N];
+    bool solved = counted && sampler_unrank(&sampler, 0, columns);
+    long long total = !counted ? 0 : sampler.total > LLONG_MAX ? LLONG_MAX : (long long)sampler.total;
+
+    if (solved) {
+        int n = puzzle_get_size(puzzle);
+        for (int row = 0; row < n; row++) {
+            puzzle_set_cell(puzzle, row, columns[row], puzzle_get_region(puzzle, row, columns[row]));
+        }
+        puzzle_save_solution(puzzle);
+        for (int row = 0; row < n; row++) {
+            puzzle_clear_cell(puzzle, row, columns[row]);
+        }
+        puzzle->solution_count = all ? total : 1;
+    }
+    stats->solutions = total;
+    stats->nodes = (long long)sampler.states;
+    stats->interrupted = !counted;
+    stats->time = seconds_now() - start;
+    sampler_release(&sampler);
+    return solved;
+}
+
+static bool sampler_solve(void* state, Puzzle* puzzle, SolverConfig config, EngineStats* stats) {
+    (void)state;
+    return sampler_run(puzzle, config.find_all_solutions, stats);
+}
+
+static bool sampler_count(void* state, Puzzle* puzzle, SolverConfig config, EngineStats* stats) {
+    (void)state;
+    (void)config;
+    return sampler_run(puzzle, true, stats);
+}
+
+static const SolverEngine ENGINES[] = {
+    {"backtrack", "Recursive backtracking over regions", MAX_N,
+     ENGINE_CHECKPOINTS | ENGINE_REPORTS_EACH | ENGINE_PROGRESS,
+     NULL, NULL, backtrack_solve, NULL},
+    {"iterative", "Explicit-stack backtracking, raster order", MAX_N,
+     ENGINE_CHECKPOINTS | ENGINE_RASTER_ONLY | ENGINE_REPORTS_EACH | ENGINE_PROGRESS,
+     NULL, NULL, iterative_solve, NULL},
+    {"backjump", "Conflict-directed backjumping with nogoods", MAX_N,
+     ENGINE_RASTER_ONLY | ENGINE_REPORTS_EACH | ENGINE_PROGRESS,
+     NULL, NULL, backjump_solve, NULL},
+    {"portfolio", "Four strategies raced on threads", MAX_N, 0,
+     NULL, NULL, portfolio_engine_solve, NULL},
+    {"table", "Scan of every non-touching column permutation", PERMTABLE_MAX_N, 0,
+     table_init, table_release, table_solve, NULL},
+    {"sampler", "Memoised count of every search state", ENGINE_SAMPLER_MAX_N, 0,
+     NULL, NULL, sampler_solve, sampler_count},
+};
+
+_Static_assert(sizeof(ENGINES) / sizeof(ENGINES[0]) <= ENGINE_MAX, "Raise ENGINE_MAX");
+
+int engine_count(void) {
+    return (int)(sizeof(ENGINES) / sizeof(ENGINES[0]));
+}
+
+const SolverEngine* engine_get(int index) {
+    return index >= 0 && index < engine_count() ? &ENGINES[index] : NULL;
+}
+
+const SolverEngine* engine_find(const char* name) {
+    for (int i = 0; i < engine_count(); i++) {
+        if (strcmp(ENGINES[i].name, name) == 0) {
+            return &ENGINES[i];
+        }
+    }
+    return NULL;
+}
+
+bool engine_call(const SolverEngine* engine, void* state, Puzzle* puzzle, SolverConfig config,
+                 bool count, EngineStats* stats) {
+    memset(stats, 0, sizeof(*stats));
+    if (count && engine->count) {
+        return engine->count(state, puzzle, config, stats);
+    }
+    config.find_all_solutions = config.find_all_solutions || count;
+    return engine->solve(state, puzzle, config, stats);
+}
+
+bool engine_run(const SolverEngine* engine, Puzzle* puzzle, SolverConfig config, bool count,
+                EngineStats* stats) {
+    memset(stats, 0, sizeof(*stats));
+    if (puzzle_get_size(puzzle) > engine->max_n) {
+        return false;
+    }
+
+    void* state = NULL;
+    if (engine->init && !engine->init(&state, puzzle_get_size(puzzle))) {
+        return false;
+    }
+    bool solved = engine_call(engine, state, puzzle, config, count, stats);
+    if (engine->release) {
+        engine->release(state);
+    }
+    return solved;
+}
@@ -0,0 +1,59 @@
+#ifndef ENGINE_H
+#define ENGINE_H
+
+#include "puzzle.h"
+#include "solver.h"
+
+#define ENGINE_MAX 16       // Registry capacity
+
+/* What one engine call did */
+typedef struct {
+    long long solutions;
+    long long nodes;            // Search nodes (-1 if the engine does not count them)
+    double time;                // Wall-clock seconds
+    bool interrupted;           // Stopped by cancel flag or node limit
+} EngineStats;
+
+/* What an engine honours beyond solve and count */
+enum {
+    ENGINE_CHECKPOINTS = 1,     // Saves and resumes through config.checkpoint_path and config.resume
+    ENGINE_RASTER_ONLY = 2,     // Ignores config.value_order and searches in raster order
+    ENGINE_REPORTS_EACH = 4,    // Calls config.on_solution with every solution
+    ENGINE_PROGRESS = 8         // Publishes its counters to config.progress
+};
+
+/* A complete search algorithm behind one interface. solve leaves the first
+ * solution (and with config.find_all_solutions, the count) in the puzzle like
+ * solver_solve. count reports the number of solutions in stats->solutions; an
+ * engine without a faster way leaves it NULL and solve enumerates instead. */
+typedef struct {
+    const char* name;
+    const char* description;
+    int max_n;                                  // Largest board the engine accepts
+    int features;                               // ENGINE_* flags
+    bool (*init)(void** state, int n);          // Per-size setup (NULL = none)
+    void (*release)(void* state);               // Undo init (NULL = none)
+    bool (*solve)(void* state, Puzzle* puzzle, SolverConfig config, EngineStats* stats);
+    bool (*count)(void* state, Puzzle* puzzle, SolverConfig config, EngineStats* stats);  // NULL = solve all
+} SolverEngine;
+
+/* Number of registered engines */
+int engine_count(void);
+
+/* Engine by index, in registration order */
+const SolverEngine* engine_get(int index);
+
+/* Engine by name, or NULL */
+const SolverEngine* engine_find(const char* name);
+
+/* solve, or count (falling back to solve for every solution), with state from
+ * the engine's init for this board size */
+bool engine_call(const SolverEngine* engine, void* state, Puzzle* puzzle, SolverConfig config,
+                 bool count, EngineStats* stats);
+
+/* init, engine_call, release in one call; false if the engine cannot take
+ * this board or finds no solution */
+bool engine_run(const SolverEngine* engine, Puzzle* puzzle, SolverConfig config, bool count,
+                EngineStats* stats);
+
+#endif
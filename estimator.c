@@ -0,0 +1,113 @@
+#include "estimator.h"
+#include "validator.h"
+#include <math.h>
+#include <stdint.h>
+#include <time.h>
+
+static uint64_t next_random(uint64_t* state) {
+    uint64_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    *state = x;
+    return x;
+}
+
+/*
+ * One random dive. Every level multiplies the weight by its number of legal
+ * cells; nodes accumulate weight * cells tried, exactly as solver_backtrack counts them.
+ */
+static void probe(Puzzle* puzzle, uint64_t* rng, double* nodes, double* solutions) {
+    int n = puzzle_get_size(puzzle);
+    int placed_row[MAX_N];
+    int placed_col[MAX_N];
+    int depth = 0;
+    double weight = 1.0;
+
+    *nodes = 0.0;
+    *solutions = 0.0;
+
+    for (int region = 0; region < n; region++) {
+        int region_cell_count = puzzle->region_size[region];
+        int legal[MAX_N * MAX_N];
+        int legal_count = 0;
+
+        *nodes += weight * region_cell_count;
+
+        for (int i = 0; i < region_cell_count; i++) {
+            int row = puzzle->region_cells_row[region][i];
+            int col = puzzle->region_cells_col[region][i];
+            if (validator_can_place(puzzle, row, col, region)) {
+                legal[legal_count++] = i;
+            }
+        }
+
+        if (legal_count == 0) {
+            break;
+        }
+
+        int pick = legal[next_random(rng) % (uint64_t)legal_count];
+        int row = puzzle->region_cells_row[region][pick];
+        int col = puzzle->region_cells_col[region][pick];
+
+        puzzle_set_cell(puzzle, row, col, region);
+        puzzle_mark_row_used(puzzle, row, true);
+        puzzle_mark_col_used(puzzle, col, true);
+        placed_row[depth] = row;
+        placed_col[depth] = col;
+        depth++;
+
+        weight *= legal_count;
+    }
+
+    if (depth == n) {
+        *solutions = weight;
+    }
+
+    // Undo the dive
+    for (int i = 0; i < depth; i++) {
+        puzzle_clear_cell(puzzle, placed_row[i], placed_col[i]);
+        puzzle_mark_row_used(puzzle, placed_row[i], false);
+        puzzle_mark_col_used(puzzle, placed_col[i], false);
+    }
+}
+
+bool estimator_run(Puzzle* puzzle, int probes, unsigned int seed, TreeEstimate* estimate) {
+    if (probes < 1) {
+        return false;
+    }
+
+    clock_t start = clock();
+    uint64_t rng = ((uint64_t)seed << 32) ^ 0x9E3779B97F4A7C15ull;
+
+    double node_sum = 0.0, node_sq = 0.0;
+    double sol_sum = 0.0, sol_sq = 0.0;
+
+    for (int i = 0; i < probes; i++) {
+        double nodes, solutions;
+        probe(puzzle, &rng, &nodes, &solutions);
+        node_sum += nodes;
+        node_sq += nodes * nodes;
+        sol_sum += solutions;
+        sol_sq += solutions * solutions;
+    }
+
+    double k = (double)probes;
+    double node_mean = node_sum / k;
+    double sol_mean = sol_sum / k;
+    double node_var = probes > 1 ? fmax(0.0, (node_sq - k * node_mean * node_mean) / (k - 1)) : 0.0;
+    double sol_var = probes > 1 ? fmax(0.0, (sol_sq - k * sol_mean * sol_mean) / (k - 1)) : 0.0;
+    double node_margin = 1.96 * sqrt(node_var / k);
+    double sol_margin = 1.96 * sqrt(sol_var / k);
+
+    estimate->probes = probes;
+    estimate->nodes = node_mean;
+    estimate->nodes_ci_low = fmax(0.0, node_mean - node_margin);
+    estimate->nodes_ci_high = node_mean + node_margin;
+    estimate->solutions = sol_mean;
+    estimate->solutions_ci_low = fmax(0.0, sol_mean - sol_margin);
+    estimate->solutions_ci_high = sol_mean + sol_margin;
+    estimate->probe_time = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+    return true;
+}
@@ -0,0 +1,21 @@
+#ifndef ESTIMATOR_H
+#define ESTIMATOR_H
+
+#include "puzzle.h"
+
+/* Knuth random-probe estimate of the solver_backtrack search tree */
+typedef struct TreeEstimate {
+    int probes;                 // Random dives performed
+    double nodes;               // Estimated nodes for a full (--all) enumeration
+    double nodes_ci_low;        // 95% confidence interval on nodes
+    double nodes_ci_high;
+    double solutions;           // Estimated number of solutions
+    double solutions_ci_low;
+    double solutions_ci_high;
+    double probe_time;          // Seconds spent probing
+} TreeEstimate;
+
+/* Run `probes` random dives using the solver's region and cell order */
+bool estimator_run(Puzzle* puzzle, int probes, unsigned int seed, TreeEstimate* estimate);
+
+#endif
@@ -0,0 +1,342 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "givens.h"
+#include "sampler.h"
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+typedef struct {
+    HintSolver solver;
+    int n;
+    int target[MAX_N];
+    int cores[GIVENS_MAX_CORES][MAX_N];     // Other known solutions
+    uint32_t differ[GIVENS_MAX_CORES];      // Rows where each differs from target
+    int core_count;
+    bool cores_full;                        // A core was dropped at GIVENS_MAX_CORES
+    double deadline;                        // 0 = none
+    long checks;
+    bool timed_out;
+} GivensSearch;
+
+/* A set of givens: queens on target cells and at most one crossed-out cell per row */
+typedef struct {
+    uint32_t queen_rows;
+    int ban_col[MAX_N];                     // -1 = none
+} GivenSet;
+
+/* Branch and bound for a smallest set of rows meeting every differ mask */
+typedef struct {
+    const uint32_t* sets;
+    int count;
+    uint32_t best;
+    int best_size;                          // Only sets smaller than this are wanted
+    bool found;
+    bool aborted;
+    long nodes;
+    double deadline;
+} HitSearch;
+
+static double seconds_now(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec + (double)now.tv_nsec / 1e9;
+}
+
+static bool out_of_time(GivensSearch* search) {
+    if (search->deadline > 0 && seconds_now() > search->deadline) {
+        search->timed_out = true;
+    }
+    return search->timed_out;
+}
+
+static void add_core(GivensSearch* search, const int* columns) {
+    uint32_t differ = 0;
+    for (int row = 0; row < search->n; row++) {
+        if (columns[row] != search->target[row]) differ |= 1u << row;
+    }
+    if (!differ) {
+        return;
+    }
+    for (int i = 0; i < search->core_count; i++) {
+        if (search->differ[i] == differ &&
+            memcmp(search->cores[i], columns, sizeof(int) * search->n) == 0) {
+            return;
+        }
+    }
+    if (search->core_count == GIVENS_MAX_CORES) {
+        search->cores_full = true;
+        return;
+    }
+    memcpy(search->cores[search->core_count], columns, sizeof(int) * search->n);
+    search->differ[search->core_count++] = differ;
+}
+
+static int set_to_assumptions(const GivensSearch* search, const GivenSet* set, Assumption* givens) {
+    int count = 0;
+    for (int row = 0; row < search->n; row++) {
+        if (set->queen_rows & (1u << row)) {
+            givens[count++] = (Assumption){row, search->target[row], true};
+        }
+    }
+    for (int row = 0; row < search->n; row++) {
+        if (set->ban_col[row] >= 0) {
+            givens[count++] = (Assumption){row, set->ban_col[row], false};
+        }
+    }
+    return count;
+}
+
+/*
+ * Look for a solution other than target under the givens, one query per row
+ * without a queen given. Every solution found joins the cores; with collect
+ * the pass runs over all rows to find several at once. Running out of time,
+ * in a query or between them, counts as not unique.
+ */
+static bool has_other_solution(GivensSearch* search, const GivenSet* set, bool collect) {
+    Assumption trial[2 * MAX_N + 1];
+    int count = set_to_assumptions(search, set, trial);
+    bool found = false;
+
+    for (int row = 0; row < search->n; row++) {
+        if (set->queen_rows & (1u << row)) {
+            continue;
+        }
+        if (out_of_time(search)) {
+            return true;
+        }
+        int columns[MAX_N];
+        trial[count] = (Assumption){row, search->target[row], false};
+        search->checks++;
+        if (hints_solve(&search->solver, trial, count + 1, columns)) {
+            add_core(search, columns);
+            found = true;
+            if (!collect) {
+                return true;
+            }
+        } else if (search->solver.interrupted) {
+            search->timed_out = true;
+            return true;
+        }
+    }
+    return found;
+}
+
+static void hit_search(HitSearch* hit, uint32_t chosen, uint32_t excluded, int size) {
+    if (hit->aborted) {
+        return;
+    }
+    if ((++hit->nodes & 1023) == 0 && hit->deadline > 0 && seconds_now() > hit->deadline) {
+        hit->aborted = true;
+        return;
+    }
+
+    // Branch on the open set with the fewest choices; disjoint open sets bound the rest
+    int pick = -1, fewest = MAX_N + 1, bound = 0;
+    uint32_t claimed = 0;
+    for (int i = 0; i < hit->count; i++) {
+        if (hit->sets[i] & chosen) {
+            continue;
+        }
+        uint32_t open = hit->sets[i] & ~excluded;
+        if (!open) {
+            return;
+        }
+        int choices = __builtin_popcount(open);
+        if (choices < fewest) {
+            fewest = choices;
+            pick = i;
+        }
+        if (!(open & claimed)) {
+            bound++;
+            claimed |= open;
+        }
+    }
+
+    if (pick < 0) {
+        if (size < hit->best_size) {
+            hit->best = chosen;
+            hit->best_size = size;
+            hit->found = true;
+        }
+        return;
+    }
+    if (size + bound >= hit->best_size) {
+        return;
+    }
+
+    for (uint32_t open = hit->sets[pick] & ~excluded; open; open &= open - 1) {
+        uint32_t row = open & -open;
+        hit_search(hit, chosen | row, excluded, size + 1);
+        excluded |= row;
+    }
+}
+
+/*
+ * Greedy start: keep adding the row of the newest counterexample that meets
+ * the most known cores until the target is unique
+ */
+static bool greedy_givens(GivensSearch* search, GivenSet* set) {
+    set->queen_rows = 0;
+    while (has_other_solution(search, set, false)) {
+        if (search->timed_out || search->cores_full) {
+            return false;
+        }
+        uint32_t open = search->differ[search->core_count - 1] & ~set->queen_rows;
+        int best_row = -1, best_hits = -1;
+        for (; open; open &= open - 1) {
+            int row = __builtin_ctz(open);
+            int hits = 0;
+            for (int i = 0; i < search->core_count; i++) {
+                hits += (search->differ[i] & ~set->queen_rows & (1u << row)) != 0;
+            }
+            if (hits > best_hits) {
+                best_hits = hits;
+                best_row = row;
+            }
+        }
+        if (best_row < 0) {
+            return false;
+        }
+        set->queen_rows |= 1u << best_row;
+    }
+    return true;
+}
+
+/*
+ * Replace each queen given by a crossed-out cell where the cores allow one:
+ * every core only that queen rules out must share the cell
+ */
+static void weaken_givens(GivensSearch* search, GivenSet* set) {
+    for (int row = 0; row < search->n; row++) {
+        uint32_t bit = 1u << row;
+        if (!(set->queen_rows & bit)) {
+            continue;
+        }
+
+        int col = -1;
+        bool possible = true;
+        for (int i = 0; i < search->core_count && possible; i++) {
+            bool hit_elsewhere = (search->differ[i] & set->queen_rows & ~bit) != 0;
+            for (int r = 0; r < search->n && !hit_elsewhere; r++) {
+                hit_elsewhere = set->ban_col[r] >= 0 && search->cores[i][r] == set->ban_col[r];
+            }
+            if (hit_elsewhere || !(search->differ[i] & bit)) {
+                continue;
+            }
+            if (col >= 0 && search->cores[i][row] != col) {
+                possible = false;
+            }
+            col = search->cores[i][row];
+        }
+        if (!possible || col < 0) {
+            continue;
+        }
+
+        GivenSet trial = *set;
+        trial.queen_rows &= ~bit;
+        trial.ban_col[row] = col;
+        if (!has_other_solution(search, &trial, true)) {
+            *set = trial;
+        }
+        if (search->timed_out) {
+            return;
+        }
+    }
+}
+
+bool givens_find(const Puzzle* puzzle, const int* target, GivensConfig config, GivensResult* result) {
+    double start = seconds_now();
+    int n = puzzle_get_size(puzzle);
+
+    memset(result, 0, sizeof(*result));
+    GivensSearch* search = (GivensSearch*)malloc(sizeof(GivensSearch));
+    if (!search) {
+        return false;
+    }
+    hints_init(&search->solver, puzzle);
+    search->n = n;
+    search->core_count = 0;
+    search->cores_full = false;
+    search->checks = 0;
+    search->timed_out = false;
+    search->deadline = config.time_limit > 0 ? start + config.time_limit : 0;
+    search->solver.deadline = search->deadline;
+
+    // The solution to single out
+    if (target) {
+        Assumption queens[MAX_N];
+        for (int row = 0; row < n; row++) {
+            queens[row] = (Assumption){row, target[row], true};
+        }
+        result->solvable = hints_solve(&search->solver, queens, n, search->target);
+    } else {
+        result->solvable = hints_solve(&search->solver, NULL, 0, search->target);
+    }
+    if (!result->solvable) {
+        result->timed_out = search->solver.interrupted;
+        free(search);
+        return false;
+    }
+    memcpy(result->target, search->target, sizeof(int) * n);
+
+    // Uniform samples give the hitting set a varied start
+    if (n <= GIVENS_SAMPLE_MAX_N) {
+        Sampler sampler;
+        if (sampler_init(&sampler, puzzle, config.seed)) {
+            int columns[MAX_N];
+            for (int i = 0; i < GIVENS_SAMPLES && sampler_draw(&sampler, columns); i++) {
+                add_core(search, columns);
+            }
+        }
+        sampler_release(&sampler);
+    }
+
+    // Any n - 1 queens leave one cell for the last; the greedy set usually beats that
+    GivenSet best;
+    best.queen_rows = n > 1 ? ((n == 32 ? 0xFFFFFFFFu : (1u << n) - 1) & ~1u) : 0;
+    for (int row = 0; row < MAX_N; row++) {
+        best.ban_col[row] = -1;
+    }
+    GivenSet greedy = best;
+    if (greedy_givens(search, &greedy)) {
+        best = greedy;
+    }
+
+    // Smallest hitting set of the known cores, until one is unique; once cores
+    // are being dropped the same counterexample can come back forever
+    while (!out_of_time(search) && !search->cores_full) {
+        HitSearch hit = {search->differ, search->core_count, 0,
+                         __builtin_popcount(best.queen_rows), false, false, 0, search->deadline};
+        hit_search(&hit, 0, 0, 0);
+        if (hit.aborted) {
+            search->timed_out = true;
+            break;
+        }
+        if (!hit.found) {
+            result->optimal = true;
+            break;
+        }
+
+        GivenSet candidate = best;
+        candidate.queen_rows = hit.best;
+        if (!has_other_solution(search, &candidate, true)) {
+            best = candidate;
+            result->optimal = true;
+            break;
+        }
+    }
+
+    if (config.prefer_bans && !search->timed_out) {
+        weaken_givens(search, &best);
+    }
+
+    result->count = set_to_assumptions(search, &best, result->givens);
+    result->timed_out = search->timed_out;
+    result->cores_full = search->cores_full;
+    result->cores = search->core_count;
+    result->checks = search->checks;
+    result->time = seconds_now() - start;
+    free(search);
+    return true;
+}
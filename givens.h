@@ -0,0 +1,38 @@
+#ifndef GIVENS_H
+#define GIVENS_H
+
+#include "hints.h"
+#include "puzzle.h"
+
+#define GIVENS_MAX_CORES 4096   // Other solutions kept for the hitting-set search
+#define GIVENS_SAMPLES 64       // Solutions drawn up front by the sampler
+#define GIVENS_SAMPLE_MAX_N 14  // Largest board whose states are counted for those samples
+
+typedef struct {
+    double time_limit;          // Seconds (0 = no limit); the best set so far is returned
+    bool prefer_bans;           // Swap each queen given for a crossed-out cell where one suffices
+    unsigned int seed;          // For the up-front samples
+} GivensConfig;
+
+typedef struct GivensResult {
+    bool solvable;
+    int target[MAX_N];          // The solution the givens single out, one column per row
+    Assumption givens[MAX_N];   // Pre-placed queens and crossed-out cells
+    int count;
+    bool optimal;               // No smaller set of givens exists
+    bool timed_out;
+    bool cores_full;            // Stopped with GIVENS_MAX_CORES other solutions known
+    int cores;                  // Other solutions the search had to rule out
+    long checks;                // Uniqueness queries
+    double time;                // Seconds
+} GivensResult;
+
+/* Find a smallest set of givens under which target (NULL = the first
+ * solution found) is the only solution. An implicit hitting set: the rows
+ * where each known other solution differs from target must be hit by a queen
+ * given, the smallest hitting set is checked for uniqueness, and every
+ * solution the check finds joins the known set. False if the map has no
+ * solution or target is not one. */
+bool givens_find(const Puzzle* puzzle, const int* target, GivensConfig config, GivensResult* result);
+
+#endif
@@ -0,0 +1,271 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "hints.h"
+#include <string.h>
+#include <time.h>
+
+/*
+ * Place a queen in the candidate masks: clear its column and region
+ * everywhere and the touching cells in the neighbouring rows
+ */
+static void apply_queen(const Bitboard* board, uint32_t* domain, int row, int col) {
+    int region = board->region[row][col];
+    uint32_t bit = 1u << col;
+    uint32_t touch = bitboard_touching(bit, board->full);
+
+    for (int r = 0; r < board->n; r++) {
+        if (r != row) {
+            domain[r] &= ~bit & ~board->region_cols[region][r];
+        }
+    }
+    if (row > 0) domain[row - 1] &= ~touch;
+    if (row + 1 < board->n) domain[row + 1] &= ~touch;
+    domain[row] &= bit;
+}
+
+/*
+ * Candidate masks under a set of assumptions; false if they contradict each other
+ */
+static bool propagate_assumptions(const Bitboard* board, const Assumption* assumptions,
+                                  int count, uint32_t* domain) {
+    int n = board->n;
+    for (int r = 0; r < n; r++) {
+        domain[r] = board->full;
+    }
+
+    for (int i = 0; i < count; i++) {
+        const Assumption* a = &assumptions[i];
+        if (a->row < 0 || a->row >= n || a->col < 0 || a->col >= n) {
+            return false;
+        }
+        if (!a->queen) {
+            domain[a->row] &= ~(1u << a->col);
+        }
+    }
+    for (int i = 0; i < count; i++) {
+        const Assumption* a = &assumptions[i];
+        if (a->queen) {
+            if (!(domain[a->row] & (1u << a->col))) {
+                return false;
+            }
+            apply_queen(board, domain, a->row, a->col);
+        }
+    }
+
+    for (int r = 0; r < n; r++) {
+        if (!domain[r]) return false;
+    }
+    return true;
+}
+
+/*
+ * Forward check below row: every row keeps a candidate and every region not
+ * yet used keeps a reachable cell
+ */
+static bool lookahead(const Bitboard* board, const uint32_t* avail, int row, uint32_t regions_used) {
+    uint32_t reachable = regions_used;
+
+    for (int r = row; r < board->n; r++) {
+        uint32_t cols = avail[r];
+        if (!cols) {
+            return false;
+        }
+        while (cols) {
+            int c = bitboard_first(cols);
+            cols &= cols - 1;
+            reachable |= 1u << board->region[r][c];
+        }
+    }
+    return reachable == board->full;
+}
+
+static bool descend(HintSolver* solver, const uint32_t* avail, int row, uint32_t regions_used,
+                    int* columns) {
+    const Bitboard* board = &solver->board;
+    int n = board->n;
+
+    // Only hints_solve sets a deadline; the clock is read every few nodes
+    if ((++solver->nodes & 1023) == 0 && solver->deadline > 0) {
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        solver->interrupted = (double)now.tv_sec + (double)now.tv_nsec / 1e9 > solver->deadline;
+    }
+    if (solver->interrupted) {
+        return false;
+    }
+    if (row == n) {
+        return true;
+    }
+
+    uint32_t cols = avail[row];
+    while (cols) {
+        int col = bitboard_first(cols);
+        cols &= cols - 1;
+
+        int region = board->region[row][col];
+        if (regions_used & (1u << region)) {
+            continue;
+        }
+
+        uint32_t bit = 1u << col;
+        uint32_t next[MAX_N];
+        for (int r = row + 1; r < n; r++) {
+            next[r] = avail[r] & ~bit & ~board->region_cols[region][r];
+        }
+        if (row + 1 < n) {
+            next[row + 1] &= ~bitboard_touching(bit, board->full);
+        }
+
+        uint32_t used = regions_used | (1u << region);
+        if (!lookahead(board, next, row + 1, used)) {
+            continue;
+        }
+
+        columns[row] = col;
+        if (descend(solver, next, row + 1, used, columns)) {
+            return true;
+        }
+        if (solver->interrupted) {
+            return false;
+        }
+    }
+    return false;
+}
+
+static void remember(HintSolver* solver, const int* columns) {
+    memcpy(solver->witness[solver->next_witness], columns, sizeof(int) * MAX_N);
+    solver->next_witness = (solver->next_witness + 1) % HINTS_MAX_WITNESSES;
+    if (solver->witnesses < HINTS_MAX_WITNESSES) {
+        solver->witnesses++;
+    }
+}
+
+static bool fits(const HintSolver* solver, const int* columns, const uint32_t* domain) {
+    for (int r = 0; r < solver->board.n; r++) {
+        if (!(domain[r] & (1u << columns[r]))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*
+ * Search under candidate masks, answering from the witnesses first
+ */
+static bool solve_domain(HintSolver* solver, const uint32_t* domain, int* columns, bool* cached) {
+    for (int i = 0; i < solver->witnesses; i++) {
+        if (fits(solver, solver->witness[i], domain)) {
+            if (columns) memcpy(columns, solver->witness[i], sizeof(int) * MAX_N);
+            *cached = true;
+            return true;
+        }
+    }
+
+    *cached = false;
+    int found[MAX_N];
+    if (!lookahead(&solver->board, domain, 0, 0) || !descend(solver, domain, 0, 0, found)) {
+        return false;
+    }
+    remember(solver, found);
+    if (columns) memcpy(columns, found, sizeof(found));
+    return true;
+}
+
+void hints_init(HintSolver* solver, const Puzzle* puzzle) {
+    bitboard_from_puzzle(&solver->board, puzzle);
+    solver->witnesses = 0;
+    solver->next_witness = 0;
+    solver->nodes = 0;
+    solver->deadline = 0;
+    solver->interrupted = false;
+}
+
+bool hints_solve(HintSolver* solver, const Assumption* assumptions, int count, int* columns) {
+    uint32_t domain[MAX_N];
+    bool cached;
+    solver->interrupted = false;
+    return propagate_assumptions(&solver->board, assumptions, count, domain) &&
+           solve_domain(solver, domain, columns, &cached);
+}
+
+bool hints_map(HintSolver* solver, const Assumption* base, int count, HintMap* map) {
+    const Bitboard* board = &solver->board;
+    int n = board->n;
+    uint32_t root[MAX_N];
+    bool cached;
+
+    solver->deadline = 0;
+    solver->interrupted = false;
+
+    memset(map->cell, HINT_EMPTY, sizeof(map->cell));
+    map->queens = 0;
+    map->empties = 0;
+    map->searches = 0;
+    map->cache_hits = 0;
+    map->solvable = propagate_assumptions(board, base, count, root) &&
+                    solve_domain(solver, root, NULL, &cached);
+    if (!map->solvable) {
+        return false;
+    }
+
+    // Columns some known solution uses in each row
+    uint32_t seen[MAX_N] = {0};
+    for (int i = 0; i < solver->witnesses; i++) {
+        if (fits(solver, solver->witness[i], root)) {
+            for (int r = 0; r < n; r++) seen[r] |= 1u << solver->witness[i][r];
+        }
+    }
+
+    int columns[MAX_N];
+    for (int row = 0; row < n; row++) {
+        uint32_t cols = root[row];
+        while (cols) {
+            int col = bitboard_first(cols);
+            uint32_t bit = 1u << col;
+            cols &= cols - 1;
+
+            // Can a solution put a queen here?
+            bool queen_possible = (seen[row] & bit) != 0;
+            if (!queen_possible) {
+                uint32_t domain[MAX_N];
+                memcpy(domain, root, sizeof(domain));
+                apply_queen(board, domain, row, col);
+                queen_possible = solve_domain(solver, domain, columns, &cached);
+                map->searches += !cached;
+                map->cache_hits += cached;
+                if (queen_possible) {
+                    for (int r = 0; r < n; r++) seen[r] |= 1u << columns[r];
+                }
+            } else {
+                map->cache_hits++;
+            }
+
+            // Can a solution leave it empty?
+            bool empty_possible = (seen[row] & ~bit) != 0;
+            if (!empty_possible) {
+                uint32_t domain[MAX_N];
+                memcpy(domain, root, sizeof(domain));
+                domain[row] &= ~bit;
+                empty_possible = domain[row] && solve_domain(solver, domain, columns, &cached);
+                map->searches += !cached;
+                map->cache_hits += cached;
+                if (empty_possible) {
+                    for (int r = 0; r < n; r++) seen[r] |= 1u << columns[r];
+                }
+            } else {
+                map->cache_hits++;
+            }
+
+            map->cell[row][col] = !queen_possible ? HINT_EMPTY :
+                                  !empty_possible ? HINT_QUEEN : HINT_OPEN;
+        }
+    }
+
+    for (int row = 0; row < n; row++) {
+        for (int col = 0; col < n; col++) {
+            map->queens += map->cell[row][col] == HINT_QUEEN;
+            map->empties += map->cell[row][col] == HINT_EMPTY;
+        }
+    }
+    return true;
+}
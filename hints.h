@@ -0,0 +1,58 @@
+#ifndef HINTS_H
+#define HINTS_H
+
+#include "bitboard.h"
+#include "puzzle.h"
+
+#define HINTS_MAX_WITNESSES 64
+
+/* A forced queen (queen = true) or an excluded cell */
+typedef struct {
+    int row;
+    int col;
+    bool queen;
+} Assumption;
+
+/* What every solution under the assumptions agrees on */
+typedef enum {
+    HINT_OPEN,              // Some solutions put a queen here, some do not
+    HINT_QUEEN,             // Every solution has a queen here
+    HINT_EMPTY              // No solution has a queen here
+} HintCell;
+
+typedef struct HintMap {
+    bool solvable;
+    unsigned char cell[MAX_N][MAX_N];   // HintCell values
+    int queens;             // Cells forced to a queen, assumptions included
+    int empties;            // Cells ruled out, assumptions included
+    long searches;          // Queries that needed a search
+    long cache_hits;        // Queries answered by a cached solution
+} HintMap;
+
+/* Assumption solver for one region map. Solutions it finds are kept as
+ * witnesses: any later query they satisfy is answered without searching. */
+typedef struct {
+    Bitboard board;
+    int witness[HINTS_MAX_WITNESSES][MAX_N];    // Cached solutions, one column per row
+    int witnesses;
+    int next_witness;                           // Ring position for the next one
+    long nodes;                                 // Search nodes over all queries
+    double deadline;                            // CLOCK_MONOTONIC seconds; hints_solve gives up
+                                                // after it (0 = none)
+    bool interrupted;                           // The last hints_solve gave up at the deadline
+} HintSolver;
+
+/* Prepare a solver for the puzzle's region map */
+void hints_init(HintSolver* solver, const Puzzle* puzzle);
+
+/* Is the map solvable under the assumptions? Fills columns with a solution
+ * when it is not NULL and the answer is yes. Also false when the query passes
+ * the deadline, with interrupted set. */
+bool hints_solve(HintSolver* solver, const Assumption* assumptions, int count, int* columns);
+
+/* Decide every cell under the base assumptions: a cell is a queen if banning it
+ * is unsolvable and empty if forcing it is. The base propagation is computed
+ * once and each cell query only changes its own row. Ignores the deadline. */
+bool hints_map(HintSolver* solver, const Assumption* base, int count, HintMap* map);
+
+#endif
@@ -0,0 +1,196 @@
+#include "iterative.h"
+#include "checkpoint.h"
+#include "progress.h"
+#include <stdio.h>
+#include <time.h>
+
+#define ITERATIVE_CHECKPOINT_CHECK_NODES (1 << 20)
+
+/* One decision frame per region */
+typedef struct {
+    int next;                   // Next index into the region's cell list
+    int row;                    // Queen placed at this level
+    int col;
+} Frame;
+
+/*
+ * Queen in any of the 8 neighbours of (row, col)
+ */
+static inline bool has_adjacent_queen(const Puzzle* puzzle, int n, int row, int col) {
+    int r0 = row > 0 ? row - 1 : row;
+    int r1 = row < n - 1 ? row + 1 : row;
+    int c0 = col > 0 ? col - 1 : col;
+    int c1 = col < n - 1 ? col + 1 : col;
+
+    for (int r = r0; r <= r1; r++) {
+        for (int c = c0; c <= c1; c++) {
+            if (puzzle->board[r][c] >= 0) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void iterative_search(Puzzle* puzzle, SolverConfig config, IterativeStats* stats) {
+    const int n = puzzle->n;
+    const bool find_all = config.find_all_solutions;
+    const long node_limit = config.node_limit;
+    atomic_bool* cancel = config.cancel;
+
+    Frame stack[MAX_N + 1];
+    int path[MAX_N];
+    SearchCounters counters;    // Sampled by the progress reporter; relaxed accesses only
+    int depth = 0;
+    bool interrupted = false;
+
+    clock_t start = clock();
+    clock_t last_checkpoint = start;
+    double elapsed_before = 0.0;
+    long long next_checkpoint_check = 0;
+
+    stack[0].next = 0;
+    progress_counters_reset(&counters, 0);
+
+    // Replay the saved path; its nodes are already counted in the checkpoint
+    if (config.resume) {
+        const Checkpoint* resume = config.resume;
+        checkpoint_restore_solutions(resume, puzzle);
+        atomic_store_explicit(&counters.nodes, resume->nodes_explored, memory_order_relaxed);
+        atomic_store_explicit(&counters.solutions, puzzle->solution_count, memory_order_relaxed);
+        elapsed_before = resume->elapsed;
+
+        for (depth = 0; depth < resume->depth; depth++) {
+            int i = resume->path[depth];
+            if (i < 0 || i >= puzzle->region_size[depth]) {
+                interrupted = true;
+                break;
+            }
+
+            int row = puzzle->region_cells_row[depth][i];
+            int col = puzzle->region_cells_col[depth][i];
+            if (puzzle->row_used[row] || puzzle->col_used[col] ||
+                has_adjacent_queen(puzzle, n, row, col)) {
+                // Saved path does not fit this map: stop rather than count twice
+                interrupted = true;
+                break;
+            }
+
+            puzzle->board[row][col] = depth;
+            puzzle->row_used[row] = true;
+            puzzle->col_used[col] = true;
+            stack[depth].next = i + 1;
+            stack[depth].row = row;
+            stack[depth].col = col;
+            atomic_store_explicit(&counters.branch[depth], i, memory_order_relaxed);
+        }
+        stack[depth].next = 0;
+        atomic_store_explicit(&counters.depth, depth, memory_order_relaxed);
+    }
+
+    progress_attach(config.progress, puzzle, &counters);
+
+    while (depth >= 0 && !interrupted) {
+        Frame* frame = &stack[depth];
+
+        if (depth == n) {
+            if (puzzle->solution_count == 0) {
+                puzzle_save_solution(puzzle);
+            } else {
+                puzzle->solution_count++;
+            }
+            atomic_store_explicit(&counters.solutions, puzzle->solution_count, memory_order_relaxed);
+            if (config.on_solution) {
+                config.on_solution(puzzle, config.solution_context);
+            }
+            if (!find_all) break;
+        } else if (frame->next == 0) {
+            // Entering a new node: cancellation, budget and checkpoint polls
+            long long explored = atomic_load_explicit(&counters.nodes, memory_order_relaxed);
+            if ((cancel && atomic_load_explicit(cancel, memory_order_relaxed)) ||
+                (node_limit > 0 && explored >= node_limit)) {
+                interrupted = true;
+                break;
+            }
+
+            if (config.checkpoint_path && explored >= next_checkpoint_check) {
+                next_checkpoint_check = explored + ITERATIVE_CHECKPOINT_CHECK_NODES;
+                clock_t now = clock();
+                if ((double)(now - last_checkpoint) / CLOCKS_PER_SEC >= config.checkpoint_interval) {
+                    for (int d = 0; d < depth; d++) {
+                        path[d] = stack[d].next - 1;
+                    }
+
+                    Checkpoint checkpoint;
+                    checkpoint_capture(&checkpoint, puzzle, path, depth);
+                    checkpoint.value_order = VALUE_ORDER_RASTER;
+                    checkpoint.find_all_solutions = find_all;
+                    checkpoint.nodes_explored = explored;
+                    checkpoint.elapsed = elapsed_before + (double)(now - start) / CLOCKS_PER_SEC;
+                    if (!checkpoint_write(config.checkpoint_path, puzzle, &checkpoint) &&
+                        config.verbose) {
+                        fprintf(stderr, "Warning: Failed to write checkpoint %s\n",
+                                config.checkpoint_path);
+                    }
+                    last_checkpoint = now;
+                }
+            }
+        }
+
+        // Advance to the next legal cell of this level's region
+        bool descended = false;
+        if (depth < n) {
+            const int size = puzzle->region_size[depth];
+            const int* cells_row = puzzle->region_cells_row[depth];
+            const int* cells_col = puzzle->region_cells_col[depth];
+            int i = frame->next;
+
+            while (i < size && !descended) {
+                int row = cells_row[i];
+                int col = cells_col[i];
+                i++;
+                long long explored = atomic_load_explicit(&counters.nodes, memory_order_relaxed);
+                atomic_store_explicit(&counters.nodes, explored + 1, memory_order_relaxed);
+
+                if (!puzzle->row_used[row] && !puzzle->col_used[col] &&
+                    !has_adjacent_queen(puzzle, n, row, col)) {
+                    puzzle->board[row][col] = depth;
+                    puzzle->row_used[row] = true;
+                    puzzle->col_used[col] = true;
+                    frame->next = i;
+                    frame->row = row;
+                    frame->col = col;
+                    atomic_store_explicit(&counters.branch[depth], i - 1, memory_order_relaxed);
+                    depth++;
+                    atomic_store_explicit(&counters.depth, depth, memory_order_relaxed);
+                    stack[depth].next = 0;
+                    descended = true;
+                }
+            }
+        }
+        if (descended) {
+            continue;
+        }
+
+        // Level exhausted (or solution recorded): undo the parent's queen
+        depth--;
+        if (depth >= 0) {
+            atomic_store_explicit(&counters.depth, depth, memory_order_relaxed);
+            Frame* parent = &stack[depth];
+            puzzle->board[parent->row][parent->col] = -1;
+            puzzle->row_used[parent->row] = false;
+            puzzle->col_used[parent->col] = false;
+        }
+    }
+
+    // Leave the working board empty, as solver_backtrack does
+    for (int d = (depth < n ? depth : n) - 1; d >= 0; d--) {
+        puzzle->board[stack[d].row][stack[d].col] = -1;
+        puzzle->row_used[stack[d].row] = false;
+        puzzle->col_used[stack[d].col] = false;
+    }
+
+    progress_detach(config.progress);
+    stats->nodes_explored = atomic_load_explicit(&counters.nodes, memory_order_relaxed);
+    stats->interrupted = interrupted;
+}
@@ -0,0 +1,19 @@
+#ifndef ITERATIVE_H
+#define ITERATIVE_H
+
+#include "puzzle.h"
+#include "solver.h"
+
+/* Counters reported by the explicit-stack search */
+typedef struct {
+    long long nodes_explored;
+    bool interrupted;
+} IterativeStats;
+
+/* Backtracking over regions 0..n-1 in raster cell order with a preallocated
+ * decision stack instead of recursion. Honours cancel, node_limit,
+ * checkpoint_path and resume from the config; checkpoints are interchangeable
+ * with solver_backtrack's. */
+void iterative_search(Puzzle* puzzle, SolverConfig config, IterativeStats* stats);
+
+#endif
@@ -3,9 +3,24 @@
 #include "solver.h"
 #include "validator.h"
 #include "display.h"
+#include "permtable.h"
+#include "portfolio.h"
+#include "estimator.h"
+#include "cube.h"
+#include "checkpoint.h"
+#include "progress.h"
+#include "bench.h"
+#include "server.h"
+#include "hints.h"
+#include "deduce.h"
+#include "engine.h"
+#include "batch.h"
+#include "givens.h"
+#include "sampler.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 
 typedef struct {
     int board_size;
@@ -13,7 +28,54 @@ typedef struct {
     bool show_regions;
     bool show_help;
     RegionType region_type;
+    int shape_slack;            // --shape: percent over n before a balanced region stops growing
+    int shape_roughness;        // --shape: 0 round to 100 ragged
     bool verbose;
+    bool use_table;             // Solve by scanning the permutation table
+    const char* table_path;     // Table file to mmap (NULL = build in memory)
+    const char* gen_table_path; // Write the permutation table and exit
+    ValueOrder value_order;     // Cell ordering inside each region
+    unsigned int order_seed;    // Seed for random cell ordering
+    int portfolio_threads;      // Race this many strategies (0 = single solver)
+    SolverAlgorithm algorithm;  // Search algorithm for the single solver
+    int estimate_probes;        // Estimate search tree size instead of solving (0 = off)
+    int cube_depth;             // --cube-gen: regions expanded into cubes
+    const char* cube_path;      // --cube-gen / --cube-solve: cube file
+    int cube_worker;            // --cube-solve: this worker's index
+    int cube_workers;           // --cube-solve: total number of workers
+    const char* cube_out_path;  // --cube-solve: partial count output
+    char** merge_paths;         // --cube-merge: partial count files
+    int merge_count;
+    const char* checkpoint_path;    // Periodically save the search position here
+    double checkpoint_interval;     // Seconds between checkpoints
+    const char* resume_path;        // Continue the search saved in this checkpoint
+    int progress_interval_ms;       // Report live progress this often (0 = off)
+    const char* progress_path;      // Rewrite this status file instead of printing to stderr
+    int bench_count;                // Benchmark this many maps per size (0 = off)
+    int bench_max_n;                // Benchmark sizes board_size..bench_max_n
+    bool seed_maps;                 // Generate maps from map_seed instead of the clock
+    unsigned int map_seed;
+    bool profile;                   // Hardware performance counters in the benchmark
+    const char* verify_path;        // Check (map, solution) records from this file ("-" = stdin)
+    DisplayFormat format;           // Output format for boards
+    bool use_colors;                // Colour cells by region
+    bool compact;                   // Unframed single-character cells
+    bool dump;                      // Print every solution as it is found
+    const char* serve_path;         // Run the solve daemon on this Unix socket
+    int serve_workers;              // Worker threads for the daemon
+    bool hints;                     // Print the cells every solution agrees on
+    Assumption assumptions[MAX_N * MAX_N];  // --force / --ban cells for --hints
+    int assumption_count;
+    bool grade;                     // Solve by deduction only and report the difficulty
+    const char* engine_name;        // Solve through this registered engine (NULL = the flags above)
+    bool compare;                   // --bench: count each map with every engine and compare
+    int warm_edits;                 // --bench: edit each map and time warm re-solves (0 = off)
+    bool batch;                     // --bench: race batch_solve_many against solver_solve
+    int sample_count;               // Draw this many uniform solutions (0 = off)
+    unsigned int sample_seed;
+    bool givens;                    // Find a smallest set of givens for a unique solution
+    double givens_time;             // Seconds for --givens (0 = no limit)
+    bool prefer_bans;
 } AppConfig;
 
 AppConfig parse_arguments(int argc, char* argv[]) {
@@ -23,7 +85,53 @@ AppConfig parse_arguments(int argc, char* argv[]) {
     config.show_regions = false;
     config.show_help = false;
     config.region_type = REGION_CONTINUOUS;  // LinkedIn-like continuous regions
+    config.shape_slack = 0;
+    config.shape_roughness = 60;
     config.verbose = true;
+    config.use_table = false;
+    config.table_path = NULL;
+    config.gen_table_path = NULL;
+    config.value_order = VALUE_ORDER_RASTER;
+    config.order_seed = 1;
+    config.portfolio_threads = 0;
+    config.algorithm = SOLVER_BACKTRACK;
+    config.estimate_probes = 0;
+    config.cube_depth = 0;
+    config.cube_path = NULL;
+    config.cube_worker = 0;
+    config.cube_workers = 0;
+    config.cube_out_path = NULL;
+    config.merge_paths = NULL;
+    config.merge_count = 0;
+    config.checkpoint_path = NULL;
+    config.checkpoint_interval = 60.0;
+    config.resume_path = NULL;
+    config.progress_interval_ms = 0;
+    config.progress_path = NULL;
+    config.bench_count = 0;
+    config.bench_max_n = 0;
+    config.seed_maps = false;
+    config.map_seed = 1;
+    config.profile = false;
+    config.verify_path = NULL;
+    config.format = DISPLAY_PRETTY;
+    config.use_colors = false;
+    config.compact = false;
+    config.dump = false;
+    config.serve_path = NULL;
+    config.serve_workers = 4;
+    config.hints = false;
+    config.assumption_count = 0;
+    config.grade = false;
+    config.engine_name = NULL;
+    config.compare = false;
+    config.warm_edits = 0;
+    config.batch = false;
+    config.sample_count = 0;
+    config.sample_seed = 1;
+    config.givens = false;
+    config.givens_time = 10.0;
+    config.prefer_bans = false;
     
     if (argc < 2) {
         config.show_help = true;
@@ -39,30 +147,309 @@ AppConfig parse_arguments(int argc, char* argv[]) {
             config.show_regions = true;
         } else if (strcmp(argv[i], "-e") == 0 || strcmp(argv[i], "--edit") == 0) {
             config.region_type = REGION_INTERACTIVE;
+        } else if (strcmp(argv[i], "--balanced") == 0) {
+            config.region_type = REGION_BALANCED;
+        } else if (strcmp(argv[i], "--shape") == 0 && i + 2 < argc) {
+            config.region_type = REGION_BALANCED;
+            config.shape_slack = atoi(argv[++i]);
+            config.shape_roughness = atoi(argv[++i]);
         } else if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0) {
             config.show_help = true;
         } else if (strcmp(argv[i], "-q") == 0 || strcmp(argv[i], "--quiet") == 0) {
             config.verbose = false;
+        } else if (strcmp(argv[i], "-t") == 0 || strcmp(argv[i], "--table") == 0) {
+            config.use_table = true;
+            if (i + 1 < argc && argv[i + 1][0] != '-') {
+                config.table_path = argv[++i];
+            }
+        } else if (strcmp(argv[i], "--gen-table") == 0 && i + 1 < argc) {
+            config.gen_table_path = argv[++i];
+        } else if (strcmp(argv[i], "--order") == 0 && i + 1 < argc) {
+            i++;
+            if (strcmp(argv[i], "lcv") == 0) {
+                config.value_order = VALUE_ORDER_LCV;
+            } else if (strcmp(argv[i], "random") == 0) {
+                config.value_order = VALUE_ORDER_RANDOM;
+            } else {
+                config.value_order = VALUE_ORDER_RASTER;
+            }
+        } else if (strcmp(argv[i], "--order-seed") == 0 && i + 1 < argc) {
+            config.order_seed = (unsigned int)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "-b") == 0 || strcmp(argv[i], "--backjump") == 0) {
+            config.algorithm = SOLVER_BACKJUMP;
+        } else if (strcmp(argv[i], "-i") == 0 || strcmp(argv[i], "--iterative") == 0) {
+            config.algorithm = SOLVER_ITERATIVE;
+        } else if (strcmp(argv[i], "--estimate") == 0) {
+            config.estimate_probes = 1000;
+            if (i + 1 < argc && argv[i + 1][0] != '-') {
+                config.estimate_probes = atoi(argv[++i]);
+            }
+        } else if (strcmp(argv[i], "--cube-gen") == 0 && i + 2 < argc) {
+            config.cube_depth = atoi(argv[++i]);
+            config.cube_path = argv[++i];
+        } else if (strcmp(argv[i], "--cube-solve") == 0 && i + 4 < argc) {
+            config.cube_path = argv[++i];
+            config.cube_worker = atoi(argv[++i]);
+            config.cube_workers = atoi(argv[++i]);
+            config.cube_out_path = argv[++i];
+        } else if (strcmp(argv[i], "--checkpoint") == 0 && i + 1 < argc) {
+            config.checkpoint_path = argv[++i];
+        } else if (strcmp(argv[i], "--checkpoint-every") == 0 && i + 1 < argc) {
+            config.checkpoint_interval = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--resume") == 0 && i + 1 < argc) {
+            config.resume_path = argv[++i];
+        } else if (strcmp(argv[i], "--progress") == 0) {
+            config.progress_interval_ms = 1000;
+            if (i + 1 < argc && argv[i + 1][0] != '-') {
+                config.progress_interval_ms = atoi(argv[++i]);
+            }
+        } else if (strcmp(argv[i], "--progress-file") == 0 && i + 1 < argc) {
+            config.progress_path = argv[++i];
+            if (config.progress_interval_ms == 0) {
+                config.progress_interval_ms = 1000;
+            }
+        } else if (strcmp(argv[i], "--bench") == 0 && i + 1 < argc) {
+            config.bench_count = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--bench-max") == 0 && i + 1 < argc) {
+            config.bench_max_n = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            config.seed_maps = true;
+            config.map_seed = (unsigned int)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--profile") == 0) {
+            config.profile = true;
+        } else if (strcmp(argv[i], "--verify") == 0 && i + 1 < argc) {
+            config.verify_path = argv[++i];
+        } else if (strcmp(argv[i], "--format") == 0 && i + 1 < argc) {
+            i++;
+            if (strcmp(argv[i], "json") == 0) {
+                config.format = DISPLAY_JSON;
+            } else if (strcmp(argv[i], "minimal") == 0) {
+                config.format = DISPLAY_MINIMAL;
+            } else {
+                config.format = DISPLAY_PRETTY;
+            }
+        } else if (strcmp(argv[i], "--color") == 0) {
+            config.use_colors = true;
+        } else if (strcmp(argv[i], "--compact") == 0) {
+            config.compact = true;
+        } else if (strcmp(argv[i], "--dump") == 0) {
+            config.dump = true;
+        } else if (strcmp(argv[i], "--serve") == 0 && i + 1 < argc) {
+            config.serve_path = argv[++i];
+        } else if (strcmp(argv[i], "--workers") == 0 && i + 1 < argc) {
+            config.serve_workers = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--hints") == 0) {
+            config.hints = true;
+        } else if ((strcmp(argv[i], "--force") == 0 || strcmp(argv[i], "--ban") == 0) &&
+                   i + 2 < argc && config.assumption_count < MAX_N * MAX_N) {
+            Assumption* assumption = &config.assumptions[config.assumption_count++];
+            assumption->queen = strcmp(argv[i], "--force") == 0;
+            assumption->row = atoi(argv[++i]);
+            assumption->col = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--engine") == 0 && i + 1 < argc) {
+            config.engine_name = argv[++i];
+        } else if (strcmp(argv[i], "--compare") == 0) {
+            config.compare = true;
+        } else if (strcmp(argv[i], "--batch") == 0) {
+            config.batch = true;
+        } else if (strcmp(argv[i], "--warm") == 0 && i + 1 < argc) {
+            config.warm_edits = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--sample") == 0 && i + 1 < argc) {
+            config.sample_count = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--sample-seed") == 0 && i + 1 < argc) {
+            config.sample_seed = (unsigned int)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--givens") == 0) {
+            config.givens = true;
+        } else if (strcmp(argv[i], "--givens-time") == 0 && i + 1 < argc) {
+            config.givens = true;
+            config.givens_time = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--prefer-bans") == 0) {
+            config.prefer_bans = true;
+        } else if (strcmp(argv[i], "--grade") == 0) {
+            config.grade = true;
+        } else if (strcmp(argv[i], "--cube-merge") == 0) {
+            // Every remaining argument is a partial count file
+            config.merge_paths = &argv[i + 1];
+            config.merge_count = argc - i - 1;
+            break;
+        } else if (strcmp(argv[i], "-p") == 0 || strcmp(argv[i], "--portfolio") == 0) {
+            config.portfolio_threads = 4;
+            if (i + 1 < argc && argv[i + 1][0] != '-') {
+                config.portfolio_threads = atoi(argv[++i]);
+            }
         }
     }
     
     return config;
 }
 
+/*
+ * Map the table file if it matches the board size, otherwise build it in memory
+ */
+static bool load_permtable(PermTable* table, const char* path, int n) {
+    if (path && permtable_load(table, path)) {
+        if (table->n == n) {
+            return true;
+        }
+        permtable_release(table);
+    }
+    return permtable_build(table, n);
+}
+
 int main(int argc, char* argv[]) {
     // Parse command-line arguments
     AppConfig config = parse_arguments(argc, argv);
     
-    // Display banner
-    display_banner();
+    // Scripted formats print boards only
+    if (config.format != DISPLAY_PRETTY) {
+        config.verbose = false;
+    } else {
+        display_banner();
+    }
     
     // Show help if requested or invalid args
     if (config.show_help || config.board_size < 1 || config.board_size > MAX_N) {
         display_help();
-        printf("Example: %s 8 --regions --all\n", argv[0]);
+        printf("Engines:\n");
+        for (int i = 0; i < engine_count(); i++) {
+            printf("  %-19s %s\n", engine_get(i)->name, engine_get(i)->description);
+        }
+        printf("\nExample: %s 8 --regions --all\n", argv[0]);
         return config.board_size < 1 || config.board_size > MAX_N ? 1 : 0;
     }
     
+    // Resolve the engine before any work is done
+    const SolverEngine* engine = NULL;
+    if (config.engine_name) {
+        engine = engine_find(config.engine_name);
+        if (!engine) {
+            fprintf(stderr, "Error: Unknown engine %s (available:", config.engine_name);
+            for (int i = 0; i < engine_count(); i++) {
+                fprintf(stderr, " %s", engine_get(i)->name);
+            }
+            fprintf(stderr, ")\n");
+            return 1;
+        }
+        if (config.board_size > engine->max_n) {
+            fprintf(stderr, "Error: Engine %s handles boards up to %d\n", engine->name,
+                    engine->max_n);
+            return 1;
+        }
+    }
+    
+    // Cube-and-conquer worker and merge steps work from files only
+    if (config.cube_workers > 0) {
+        SolverConfig solver_config = solver_config_default();
+        CubeTotals totals;
+        if (!cube_solve(config.cube_path, config.cube_worker, config.cube_workers,
+                        config.cube_out_path, solver_config, &totals)) {
+            fprintf(stderr, "Error: Failed to solve cubes from %s\n", config.cube_path);
+            return 1;
+        }
+        printf("Worker %d/%d: %ld cubes, %lld solutions, %lld nodes -> %s\n",
+               config.cube_worker, config.cube_workers, totals.cubes, totals.solutions,
+               totals.nodes_explored, config.cube_out_path);
+        return 0;
+    }
+    if (config.merge_paths) {
+        CubeTotals totals;
+        if (!cube_merge(config.merge_paths, config.merge_count, &totals)) {
+            fprintf(stderr, "Error: Partial counts are unreadable, incomplete or from different cube files\n");
+            return 1;
+        }
+        printf("Merged %d parts: %ld cubes, %lld solutions, %lld nodes\n",
+               config.merge_count, totals.cubes, totals.solutions, totals.nodes_explored);
+        return 0;
+    }
+    
+    // Write the permutation table and exit
+    if (config.gen_table_path) {
+        if (!permtable_write_file(config.board_size, config.gen_table_path)) {
+            fprintf(stderr, "Error: Failed to write permutation table (n must be 1-%d)\n",
+                    PERMTABLE_MAX_N);
+            return 1;
+        }
+        printf("Wrote %dx%d permutation table to %s\n",
+               config.board_size, config.board_size, config.gen_table_path);
+        return 0;
+    }
+    
+    // Answer requests on a socket until stopped
+    if (config.serve_path) {
+        if (!server_run(config.serve_path, config.serve_workers)) {
+            fprintf(stderr, "Error: Cannot serve on %s\n", config.serve_path);
+            return 1;
+        }
+        return 0;
+    }
+    
+    // Check submitted solutions without solving anything
+    if (config.verify_path) {
+        FILE* in = strcmp(config.verify_path, "-") == 0 ? stdin : fopen(config.verify_path, "r");
+        if (!in) {
+            fprintf(stderr, "Error: Cannot open %s\n", config.verify_path);
+            return 1;
+        }
+        VerifyTotals totals;
+        clock_t start = clock();
+        bool ok = validator_verify_stream(in, stdout, &totals);
+        double elapsed = (double)(clock() - start) / CLOCKS_PER_SEC;
+        if (in != stdin) {
+            fclose(in);
+        }
+        if (!ok) {
+            fprintf(stderr, "Error: Malformed record %ld in %s\n", totals.checked + 1,
+                    config.verify_path);
+        }
+        printf("Checked %ld solutions: %ld valid, %ld invalid (%.3f s)\n",
+               totals.checked, totals.valid, totals.invalid, elapsed);
+        return ok && totals.invalid == 0 ? 0 : 1;
+    }
+    
+    region_set_shape(config.shape_slack, config.shape_roughness);
+    
+    // Solve seeded maps for a range of sizes and report per-size statistics
+    if (config.bench_count > 0) {
+        BenchConfig bench;
+        bench.min_n = config.board_size;
+        bench.max_n = config.bench_max_n > 0 ? config.bench_max_n : config.board_size;
+        bench.count = config.bench_count;
+        bench.seed = config.map_seed;
+        bench.region_type = config.region_type == REGION_BALANCED ? REGION_BALANCED
+                                                                  : REGION_CONTINUOUS;
+        bench.profile = config.profile;
+        bench.grade = config.grade;
+        bench.warm_edits = config.warm_edits;
+        bench.batch = config.batch;
+        bench.solver = solver_config_default();
+        bench.solver.find_all_solutions = config.find_all;
+        bench.solver.value_order = config.value_order;
+        bench.solver.seed = config.order_seed;
+        bench.solver.algorithm = config.algorithm;
+        if (bench.batch && bench.max_n > BATCH_MAX_N) {
+            fprintf(stderr, "Error: --batch handles boards up to %d\n", BATCH_MAX_N);
+            return 1;
+        }
+        if (config.compare) {
+            int mismatches = bench_compare(&bench);
+            if (mismatches < 0) {
+                fprintf(stderr, "Error: Invalid benchmark range %d-%d\n", bench.min_n, bench.max_n);
+            } else if (mismatches > 0) {
+                fprintf(stderr, "Error: Engines disagree on %d maps\n", mismatches);
+            }
+            return mismatches == 0 ? 0 : 1;
+        }
+        if (!bench_run(&bench)) {
+            fprintf(stderr, "Error: Invalid benchmark range %d-%d\n", bench.min_n, bench.max_n);
+            return 1;
+        }
+        return 0;
+    }
+    
+    if (config.seed_maps) {
+        region_seed(config.map_seed);
+    }
+    
     // Create puzzle instance
     Puzzle* puzzle = puzzle_create(config.board_size);
     if (!puzzle) {
@@ -70,43 +457,252 @@ int main(int argc, char* argv[]) {
         return 1;
     }
     
-    // Generate regions
-    region_generate(puzzle, config.region_type);
+    // Generate regions, or take them from the checkpoint being resumed
+    Checkpoint resume;
+    if (config.resume_path) {
+        if (!checkpoint_read(config.resume_path, puzzle, &resume)) {
+            fprintf(stderr, "Error: Failed to read checkpoint %s\n", config.resume_path);
+            puzzle_destroy(puzzle);
+            return 1;
+        }
+        config.board_size = puzzle_get_size(puzzle);
+        config.find_all = resume.find_all_solutions;
+        config.value_order = resume.value_order;
+        if (config.algorithm != SOLVER_ITERATIVE) {
+            config.algorithm = SOLVER_BACKTRACK;
+        }
+        config.portfolio_threads = 0;
+        config.use_table = false;
+        if (!config.checkpoint_path) {
+            config.checkpoint_path = config.resume_path;
+        }
+    } else {
+        region_generate(puzzle, config.region_type);
+    }
     
     // Build region cell lookup tables for optimization
     puzzle_build_region_lists(puzzle);
     
-    // Validate regions
-    if (!region_validate(puzzle)) {
-        fprintf(stderr, "Error: Invalid region configuration\n");
+    // Validate regions and check continuity in one pass
+    RegionReport region_report;
+    if (!region_analyze(puzzle, &region_report)) {
+        if (region_report.bad_row >= 0) {
+            fprintf(stderr, "Error: Invalid region configuration (cell %d,%d has id %d)\n",
+                    region_report.bad_row, region_report.bad_col,
+                    puzzle_get_region(puzzle, region_report.bad_row, region_report.bad_col));
+        } else {
+            fprintf(stderr, "Error: Invalid region configuration (region %d has no cells)\n",
+                    region_report.first_empty);
+        }
         puzzle_destroy(puzzle);
         return 1;
     }
     
-    // Check if regions are continuous
     if (config.verbose) {
-        if (region_verify_continuous(puzzle)) {
+        if (region_report.continuous) {
             printf("✓ All regions are continuous\n\n");
         } else {
-            printf("⚠ Warning: Some regions are not continuous\n\n");
+            printf("⚠ Warning: Region %d is split into %d pieces\n\n", region_report.first_split,
+                   region_report.components[region_report.first_split]);
         }
     }
     
+    // Split the enumeration into cubes for other processes
+    if (config.cube_path) {
+        long cubes = cube_generate(puzzle, config.cube_depth, config.cube_path);
+        puzzle_destroy(puzzle);
+        if (cubes < 0) {
+            fprintf(stderr, "Error: Failed to write cubes (depth must be 1-%d)\n",
+                    config.board_size);
+            return 1;
+        }
+        printf("Wrote %ld cubes of depth %d to %s\n", cubes, config.cube_depth, config.cube_path);
+        return 0;
+    }
+    
+    // Predict search cost without solving
+    if (config.estimate_probes > 0) {
+        TreeEstimate estimate;
+        if (estimator_run(puzzle, config.estimate_probes, config.order_seed, &estimate)) {
+            display_estimate(&estimate);
+        }
+        puzzle_destroy(puzzle);
+        return 0;
+    }
+    
+    // Deduce what every solution agrees on instead of solving
+    if (config.hints) {
+        HintSolver* hints = (HintSolver*)malloc(sizeof(HintSolver));
+        HintMap map;
+        if (!hints) {
+            fprintf(stderr, "Error: Failed to allocate hint solver\n");
+            puzzle_destroy(puzzle);
+            return 1;
+        }
+        hints_init(hints, puzzle);
+        hints_map(hints, config.assumptions, config.assumption_count, &map);
+        display_hints(&map, config.board_size);
+        free(hints);
+        puzzle_destroy(puzzle);
+        return map.solvable ? 0 : 1;
+    }
+    
+    // Grade the map by how far deduction alone gets
+    if (config.grade) {
+        DeduceResult result;
+        deduce_run(puzzle, &result);
+        display_deduction(puzzle, &result);
+        puzzle_destroy(puzzle);
+        return 0;
+    }
+    
+    // Design clues: the fewest givens that leave one solution
+    if (config.givens) {
+        GivensConfig givens_config;
+        givens_config.time_limit = config.givens_time;
+        givens_config.prefer_bans = config.prefer_bans;
+        givens_config.seed = config.sample_seed;
+        GivensResult result;
+        bool found = givens_find(puzzle, NULL, givens_config, &result);
+        display_givens(&result, config.board_size);
+        puzzle_destroy(puzzle);
+        return found ? 0 : 1;
+    }
+    
+    // Count every search state once, then draw solutions by weighted descent
+    if (config.sample_count > 0) {
+        Sampler sampler;
+        bool counted = sampler_init(&sampler, puzzle, config.sample_seed);
+        if (!counted) {
+            fprintf(stderr, "Error: Too many search states to sample this map (limit %d)\n",
+                    SAMPLER_MAX_STATES);
+        } else if (sampler.total == 0) {
+            printf("\nNo solution to sample\n");
+        } else {
+            display_samples(&sampler, config.sample_count);
+        }
+        sampler_release(&sampler);
+        puzzle_destroy(puzzle);
+        return counted && sampler.total > 0 ? 0 : 1;
+    }
+    
     // Configure solver
     SolverConfig solver_config = solver_config_default();
     solver_config.find_all_solutions = config.find_all;
     solver_config.verbose = config.verbose;
+    solver_config.value_order = config.value_order;
+    solver_config.seed = config.order_seed;
+    solver_config.algorithm = config.algorithm;
+    solver_config.checkpoint_path = config.checkpoint_path;
+    solver_config.checkpoint_interval = config.checkpoint_interval;
+    solver_config.resume = config.resume_path ? &resume : NULL;
+    
+    // Random cell order cannot be replayed, and only the backtrackers save their position
+    if (config.checkpoint_path && engine &&
+        (!(engine->features & ENGINE_CHECKPOINTS) || config.value_order == VALUE_ORDER_RANDOM ||
+         ((engine->features & ENGINE_RASTER_ONLY) && config.value_order != VALUE_ORDER_RASTER))) {
+        fprintf(stderr, "Error: --checkpoint and --resume need engine backtrack (raster or lcv "
+                        "order) or iterative (raster order), not %s\n", engine->name);
+        puzzle_destroy(puzzle);
+        return 1;
+    }
+    if (config.checkpoint_path && !engine &&
+        (config.value_order == VALUE_ORDER_RANDOM || config.algorithm == SOLVER_BACKJUMP ||
+         (config.algorithm == SOLVER_ITERATIVE && config.value_order != VALUE_ORDER_RASTER) ||
+         config.portfolio_threads > 0 || config.use_table)) {
+        fprintf(stderr, "Error: --checkpoint needs the backtracker (raster or lcv order) "
+                        "or --iterative (raster order)\n");
+        puzzle_destroy(puzzle);
+        return 1;
+    }
     
     // Configure display
     DisplayOptions display_options = display_options_default();
     display_options.show_regions = config.show_regions;
+    display_options.use_colors = config.use_colors;
+    display_options.compact = config.compact;
+    display_options.format = config.format;
+    
+    // Only the board-based engines report each solution as they find it
+    if (config.dump) {
+        if (engine && !(engine->features & ENGINE_REPORTS_EACH)) {
+            fprintf(stderr, "Error: --dump needs engine backtrack, backjump or iterative, not %s\n",
+                    engine->name);
+            puzzle_destroy(puzzle);
+            return 1;
+        }
+        if (!engine && (config.portfolio_threads > 0 || config.use_table)) {
+            fprintf(stderr, "Error: --dump needs the backtracker, --backjump or --iterative\n");
+            puzzle_destroy(puzzle);
+            return 1;
+        }
+        solver_config.on_solution = display_dump_solution;
+        solver_config.solution_context = &display_options;
+    }
+    
+    // Only the single-threaded searches keep counters a reporter can sample
+    if (config.progress_interval_ms > 0) {
+        if (engine && !(engine->features & ENGINE_PROGRESS)) {
+            fprintf(stderr, "Error: --progress needs engine backtrack, backjump or iterative, "
+                            "not %s\n", engine->name);
+            puzzle_destroy(puzzle);
+            return 1;
+        }
+        if (!engine && (config.portfolio_threads > 0 || config.use_table)) {
+            fprintf(stderr, "Error: --progress needs the backtracker, --backjump or --iterative\n");
+            puzzle_destroy(puzzle);
+            return 1;
+        }
+    }
+    
+    SolverProgress progress;
+    progress_init(&progress);
+    ProgressReporter* reporter = NULL;
+    if (config.progress_interval_ms > 0) {
+        solver_config.progress = &progress;
+        reporter = progress_start(&progress, config.progress_interval_ms, config.progress_path);
+    }
     
     // Solve the puzzle
-    printf("Solving %dx%d puzzle...\n\n", config.board_size, config.board_size);
+    if (config.verbose) {
+        printf("Solving %dx%d puzzle...\n\n", config.board_size, config.board_size);
+    }
     
-    if (solver_solve(puzzle, solver_config)) {
+    bool solved;
+    PermTable table;
+    if (engine) {
+        EngineStats engine_stats;
+        solved = engine_run(engine, puzzle, solver_config, false, &engine_stats);
+        if (config.verbose) {
+            printf("Engine %s: %lld solution(s) in %.6f seconds\n", engine->name,
+                   engine_stats.solutions, engine_stats.time);
+        }
+    } else if (config.use_table && load_permtable(&table, config.table_path, config.board_size)) {
+        solved = permtable_solve(puzzle, &table, solver_config);
+        permtable_release(&table);
+    } else if (config.portfolio_threads > 0) {
+        solved = portfolio_solve(puzzle, solver_config, config.portfolio_threads, NULL);
+    } else {
+        if (config.use_table) {
+            fprintf(stderr, "Warning: Permutation table unavailable, using backtracking\n");
+        }
+        solved = solver_solve(puzzle, solver_config);
+    }
+    progress_stop(reporter);
+    if (config.dump) {
+        display_flush();
+    }
+    
+    if (config.format != DISPLAY_PRETTY) {
+        // Dumped boards already went out; otherwise print the first solution
+        if (!config.dump || !solved) {
+            display_solution(puzzle, display_options);
+        }
+    } else if (solved) {
         // Display solution
-        display_solution(puzzle, display_options);
+        if (!config.dump) {
+            display_solution(puzzle, display_options);
+        }
         
         // Validate solution
         printf("\nValidating solution...\n");
@@ -125,6 +721,7 @@ int main(int argc, char* argv[]) {
     }
     
     // Cleanup
+    progress_destroy(&progress);
     puzzle_destroy(puzzle);
     
     return 0;
@@ -0,0 +1,139 @@
+#define _GNU_SOURCE
+
+#include "perfcount.h"
+#include <string.h>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+static const char* COUNTER_NAMES[PERF_COUNTER_COUNT] = {
+    "cycles", "instr", "br-miss", "l1d-miss", "llc-miss"
+};
+
+const char* perfcount_name(PerfCounter counter) {
+    return counter < PERF_COUNTER_COUNT ? COUNTER_NAMES[counter] : "?";
+}
+
+#ifdef __linux__
+
+/*
+ * Fill in the type/config pair for one event
+ */
+static void describe_event(PerfCounter counter, struct perf_event_attr* attr) {
+    const unsigned long long cache_read_miss =
+        ((unsigned long long)PERF_COUNT_HW_CACHE_OP_READ << 8) |
+        ((unsigned long long)PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+
+    switch (counter) {
+        case PERF_CYCLES:
+            attr->type = PERF_TYPE_HARDWARE;
+            attr->config = PERF_COUNT_HW_CPU_CYCLES;
+            break;
+        case PERF_INSTRUCTIONS:
+            attr->type = PERF_TYPE_HARDWARE;
+            attr->config = PERF_COUNT_HW_INSTRUCTIONS;
+            break;
+        case PERF_BRANCH_MISSES:
+            attr->type = PERF_TYPE_HARDWARE;
+            attr->config = PERF_COUNT_HW_BRANCH_MISSES;
+            break;
+        case PERF_L1D_MISSES:
+            attr->type = PERF_TYPE_HW_CACHE;
+            attr->config = PERF_COUNT_HW_CACHE_L1D | cache_read_miss;
+            break;
+        case PERF_LLC_MISSES:
+            attr->type = PERF_TYPE_HW_CACHE;
+            attr->config = PERF_COUNT_HW_CACHE_LL | cache_read_miss;
+            break;
+        default:
+            break;
+    }
+}
+
+bool perfcount_open(PerfCounters* counters) {
+    bool any = false;
+
+    for (int i = 0; i < PERF_COUNTER_COUNT; i++) {
+        struct perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        describe_event((PerfCounter)i, &attr);
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+        counters->fds[i] = (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+        any = any || counters->fds[i] >= 0;
+    }
+
+    return any;
+}
+
+void perfcount_start(PerfCounters* counters) {
+    for (int i = 0; i < PERF_COUNTER_COUNT; i++) {
+        if (counters->fds[i] >= 0) {
+            ioctl(counters->fds[i], PERF_EVENT_IOC_RESET, 0);
+            ioctl(counters->fds[i], PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+}
+
+void perfcount_stop(PerfCounters* counters, PerfSample* sample) {
+    for (int i = 0; i < PERF_COUNTER_COUNT; i++) {
+        if (counters->fds[i] >= 0) {
+            ioctl(counters->fds[i], PERF_EVENT_IOC_DISABLE, 0);
+        }
+    }
+
+    for (int i = 0; i < PERF_COUNTER_COUNT; i++) {
+        // value, time_enabled, time_running
+        unsigned long long data[3];
+        sample->values[i] = 0;
+        sample->valid[i] = counters->fds[i] >= 0 &&
+                           read(counters->fds[i], data, sizeof(data)) == (ssize_t)sizeof(data) &&
+                           data[2] > 0;
+        if (!sample->valid[i]) continue;
+
+        // Scale up when the PMU was shared with other events for part of the interval
+        double scale = data[2] < data[1] ? (double)data[1] / (double)data[2] : 1.0;
+        sample->values[i] = (long long)((double)data[0] * scale);
+    }
+}
+
+void perfcount_close(PerfCounters* counters) {
+    for (int i = 0; i < PERF_COUNTER_COUNT; i++) {
+        if (counters->fds[i] >= 0) {
+            close(counters->fds[i]);
+            counters->fds[i] = -1;
+        }
+    }
+}
+
+#else
+
+bool perfcount_open(PerfCounters* counters) {
+    for (int i = 0; i < PERF_COUNTER_COUNT; i++) {
+        counters->fds[i] = -1;
+    }
+    return false;
+}
+
+void perfcount_start(PerfCounters* counters) {
+    (void)counters;
+}
+
+void perfcount_stop(PerfCounters* counters, PerfSample* sample) {
+    (void)counters;
+    memset(sample, 0, sizeof(*sample));
+}
+
+void perfcount_close(PerfCounters* counters) {
+    (void)counters;
+}
+
+#endif
@@ -0,0 +1,44 @@
+#ifndef PERFCOUNT_H
+#define PERFCOUNT_H
+
+#include <stdbool.h>
+
+/* Hardware events sampled around each solve */
+typedef enum {
+    PERF_CYCLES,
+    PERF_INSTRUCTIONS,
+    PERF_BRANCH_MISSES,
+    PERF_L1D_MISSES,
+    PERF_LLC_MISSES,
+    PERF_COUNTER_COUNT
+} PerfCounter;
+
+/* Open counter descriptors; -1 marks an event the kernel or CPU refused */
+typedef struct {
+    int fds[PERF_COUNTER_COUNT];
+} PerfCounters;
+
+/* Counter values for one measured interval, scaled up when the kernel multiplexed */
+typedef struct {
+    long long values[PERF_COUNTER_COUNT];
+    bool valid[PERF_COUNTER_COUNT];
+} PerfSample;
+
+/* Open user-space counters for the calling thread. Returns false when none are
+ * available (non-Linux, perf_event_paranoid, containers); each event is opened
+ * on its own so a missing one does not disable the rest. */
+bool perfcount_open(PerfCounters* counters);
+
+/* Reset and enable all open counters */
+void perfcount_start(PerfCounters* counters);
+
+/* Disable the counters and read the interval since perfcount_start */
+void perfcount_stop(PerfCounters* counters, PerfSample* sample);
+
+/* Close all descriptors */
+void perfcount_close(PerfCounters* counters);
+
+/* Short column name of an event */
+const char* perfcount_name(PerfCounter counter);
+
+#endif
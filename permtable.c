@@ -0,0 +1,228 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "permtable.h"
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#define PERMTABLE_MAGIC "QPERMTB1"
+#define PERMTABLE_BLOCK 256
+
+typedef struct {
+    char magic[8];
+    uint32_t n;
+    uint32_t reserved;
+    uint64_t count;
+} PermTableHeader;
+
+/*
+ * Depth-first enumeration of king-free permutations, row by row
+ */
+static long enumerate_perms(int n, int row, int used_cols, int prev_col,
+                            unsigned char* current, unsigned char* out) {
+    if (row == n) {
+        if (out) {
+            memcpy(out, current, (size_t)n);
+        }
+        return 1;
+    }
+
+    long count = 0;
+    for (int col = 0; col < n; col++) {
+        if (used_cols & (1 << col)) continue;
+        if (row > 0 && abs(col - prev_col) <= 1) continue;
+
+        current[row] = (unsigned char)col;
+        count += enumerate_perms(n, row + 1, used_cols | (1 << col), col, current,
+                                 out ? out + count * n : NULL);
+    }
+    return count;
+}
+
+bool permtable_build(PermTable* table, int n) {
+    memset(table, 0, sizeof(*table));
+    if (n < 1 || n > PERMTABLE_MAX_N) {
+        return false;
+    }
+
+    unsigned char current[PERMTABLE_MAX_N];
+    long count = enumerate_perms(n, 0, 0, -1, current, NULL);
+
+    unsigned char* perms = (unsigned char*)malloc((size_t)(count > 0 ? count : 1) * n);
+    if (!perms) {
+        return false;
+    }
+    enumerate_perms(n, 0, 0, -1, current, perms);
+
+    table->n = n;
+    table->count = count;
+    table->perms = perms;
+    table->storage = perms;
+    table->storage_size = 0;
+    return true;
+}
+
+bool permtable_write_file(int n, const char* path) {
+    PermTable table;
+    if (!permtable_build(&table, n)) {
+        return false;
+    }
+
+    FILE* file = fopen(path, "wb");
+    if (!file) {
+        permtable_release(&table);
+        return false;
+    }
+
+    PermTableHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, PERMTABLE_MAGIC, sizeof(header.magic));
+    header.n = (uint32_t)n;
+    header.count = (uint64_t)table.count;
+
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+              fwrite(table.perms, (size_t)n, (size_t)table.count, file) == (size_t)table.count;
+    ok = (fclose(file) == 0) && ok;
+
+    permtable_release(&table);
+    return ok;
+}
+
+bool permtable_load(PermTable* table, const char* path) {
+    memset(table, 0, sizeof(*table));
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(PermTableHeader)) {
+        close(fd);
+        return false;
+    }
+
+    void* base = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        return false;
+    }
+
+    // Check n before using it, and the count against the file size before
+    // multiplying, so a corrupt header cannot wrap the size computation
+    const PermTableHeader* header = (const PermTableHeader*)base;
+    size_t body = (size_t)st.st_size - sizeof(PermTableHeader);
+    if (memcmp(header->magic, PERMTABLE_MAGIC, sizeof(header->magic)) != 0 ||
+        header->n < 1 || header->n > PERMTABLE_MAX_N ||
+        header->count > body / header->n ||
+        (size_t)header->count * header->n != body) {
+        munmap(base, (size_t)st.st_size);
+        return false;
+    }
+
+    table->n = (int)header->n;
+    table->count = (long)header->count;
+    table->perms = (const unsigned char*)base + sizeof(PermTableHeader);
+    table->storage = base;
+    table->storage_size = (size_t)st.st_size;
+    return true;
+}
+
+void permtable_release(PermTable* table) {
+    if (table->storage) {
+        if (table->storage_size > 0) {
+            munmap(table->storage, table->storage_size);
+        } else {
+            free(table->storage);
+        }
+    }
+    memset(table, 0, sizeof(*table));
+}
+
+/*
+ * Record permutation as the saved solution of the puzzle
+ */
+static void save_permutation(Puzzle* puzzle, const unsigned char* perm) {
+    int n = puzzle->n;
+    for (int row = 0; row < n; row++) {
+        puzzle_set_cell(puzzle, row, perm[row], puzzle->regions[row][perm[row]]);
+    }
+    puzzle_save_solution(puzzle);
+    for (int row = 0; row < n; row++) {
+        puzzle_clear_cell(puzzle, row, perm[row]);
+    }
+}
+
+bool permtable_solve(Puzzle* puzzle, const PermTable* table, SolverConfig config) {
+    int n = puzzle_get_size(puzzle);
+    if (table->n != n) {
+        return false;
+    }
+
+    clock_t start = clock();
+
+    // Region bit of every cell, laid out so each row is a contiguous lookup
+    uint32_t region_bit[PERMTABLE_MAX_N][PERMTABLE_MAX_N];
+    for (int row = 0; row < n; row++) {
+        for (int col = 0; col < n; col++) {
+            region_bit[row][col] = 1u << puzzle->regions[row][col];
+        }
+    }
+    const uint32_t full = (1u << n) - 1;
+
+    // Stream the table in blocks: compute region masks, then pick out the hits
+    uint32_t masks[PERMTABLE_BLOCK];
+    long matches = 0;
+    long scanned = 0;
+
+    for (long base = 0; base < table->count; base += PERMTABLE_BLOCK) {
+        int block = (int)(table->count - base < PERMTABLE_BLOCK ? table->count - base
+                                                                : PERMTABLE_BLOCK);
+        const unsigned char* perms = table->perms + base * n;
+
+        for (int i = 0; i < block; i++) {
+            const unsigned char* perm = perms + i * n;
+            uint32_t mask = 0;
+            for (int row = 0; row < n; row++) {
+                mask |= region_bit[row][perm[row]];
+            }
+            masks[i] = mask;
+        }
+        scanned = base + block;
+
+        for (int i = 0; i < block; i++) {
+            if (masks[i] != full) continue;
+
+            if (matches == 0) {
+                save_permutation(puzzle, perms + i * n);
+            }
+            matches++;
+
+            if (!config.find_all_solutions) {
+                scanned = base + i + 1;
+                break;
+            }
+        }
+
+        if (!config.find_all_solutions && matches > 0) {
+            break;
+        }
+    }
+
+    puzzle->solution_count = (int)matches;
+
+    double elapsed = (double)(clock() - start) / CLOCKS_PER_SEC;
+    if (config.verbose) {
+        printf("Solved %dx%d board in %.6f seconds\n", n, n, elapsed);
+        printf("Scanned %ld of %ld table permutations\n", scanned, table->count);
+        printf("Found %lld solution(s)\n", puzzle_get_solution_count(puzzle));
+    }
+
+    return puzzle_has_solution(puzzle);
+}
@@ -0,0 +1,35 @@
+#ifndef PERMTABLE_H
+#define PERMTABLE_H
+
+#include "puzzle.h"
+#include "solver.h"
+#include <stddef.h>
+
+/* Largest board size the permutation table is used for */
+#define PERMTABLE_MAX_N 10
+
+/* Table of all permutations with no two queens king-adjacent in consecutive rows */
+typedef struct {
+    int n;                          // Board size the table was built for
+    long count;                     // Number of permutations in the table
+    const unsigned char* perms;     // count * n bytes, perms[i * n + row] = column
+    void* storage;                  // mmap base or heap block backing perms
+    size_t storage_size;            // Size of the mapping (0 for heap storage)
+} PermTable;
+
+/* Build the table for board size n in memory */
+bool permtable_build(PermTable* table, int n);
+
+/* Write the table for board size n to a file that can later be mmapped */
+bool permtable_write_file(int n, const char* path);
+
+/* Map a table file previously written by permtable_write_file */
+bool permtable_load(PermTable* table, const char* path);
+
+/* Release memory or mapping held by the table */
+void permtable_release(PermTable* table);
+
+/* Solve by scanning the table for permutations hitting every region once */
+bool permtable_solve(Puzzle* puzzle, const PermTable* table, SolverConfig config);
+
+#endif
@@ -0,0 +1,60 @@
+#include "pool.h"
+#include <stdlib.h>
+
+bool pool_init(PuzzlePool* pool, int capacity) {
+    pool->capacity = capacity;
+    pool->available = 0;
+    pool->slots = capacity > 0 ? (Puzzle*)malloc(sizeof(Puzzle) * (size_t)capacity) : NULL;
+    pool->free_slots = capacity > 0 ? (Puzzle**)malloc(sizeof(Puzzle*) * (size_t)capacity) : NULL;
+    if (!pool->slots || !pool->free_slots) {
+        free(pool->slots);
+        free(pool->free_slots);
+        pool->slots = NULL;
+        pool->free_slots = NULL;
+        return false;
+    }
+
+    // Full initialisation once, so later resets only need the active area
+    for (int i = capacity - 1; i >= 0; i--) {
+        puzzle_init(&pool->slots[i], 1);
+        pool->free_slots[pool->available++] = &pool->slots[i];
+    }
+    pthread_mutex_init(&pool->lock, NULL);
+    return true;
+}
+
+void pool_release(PuzzlePool* pool) {
+    if (pool->slots) {
+        pthread_mutex_destroy(&pool->lock);
+    }
+    free(pool->slots);
+    free(pool->free_slots);
+    pool->slots = NULL;
+    pool->free_slots = NULL;
+    pool->capacity = 0;
+    pool->available = 0;
+}
+
+Puzzle* pool_checkout(PuzzlePool* pool, int n) {
+    if (n < 1 || n > MAX_N) {
+        return NULL;
+    }
+
+    pthread_mutex_lock(&pool->lock);
+    Puzzle* puzzle = pool->available > 0 ? pool->free_slots[--pool->available] : NULL;
+    pthread_mutex_unlock(&pool->lock);
+
+    if (puzzle) {
+        puzzle_reset(puzzle, n);
+    }
+    return puzzle;
+}
+
+void pool_checkin(PuzzlePool* pool, Puzzle* puzzle) {
+    if (!puzzle) {
+        return;
+    }
+    pthread_mutex_lock(&pool->lock);
+    pool->free_slots[pool->available++] = puzzle;
+    pthread_mutex_unlock(&pool->lock);
+}
@@ -0,0 +1,30 @@
+#ifndef POOL_H
+#define POOL_H
+
+#include "puzzle.h"
+#include <pthread.h>
+
+/* Fixed set of preallocated puzzles for callers that solve many boards back
+ * to back. Checking one out resets only its n×n area, so small solves neither
+ * hit the allocator nor sweep the whole MAX_N-sized struct. */
+typedef struct {
+    Puzzle* slots;          // All puzzles, in one allocation
+    Puzzle** free_slots;    // Puzzles not checked out; the most recently returned on top
+    int capacity;
+    int available;
+    pthread_mutex_t lock;
+} PuzzlePool;
+
+/* Allocate and initialise capacity puzzles */
+bool pool_init(PuzzlePool* pool, int capacity);
+
+/* Free the pool; every puzzle must have been checked in */
+void pool_release(PuzzlePool* pool);
+
+/* Take a puzzle reset for size n, or NULL when all are checked out. Thread-safe. */
+Puzzle* pool_checkout(PuzzlePool* pool, int n);
+
+/* Give a puzzle back to the pool it came from. Thread-safe. */
+void pool_checkin(PuzzlePool* pool, Puzzle* puzzle);
+
+#endif
@@ -0,0 +1,241 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "portfolio.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define PORTFOLIO_RESTART_BASE 1024
+
+typedef struct {
+    atomic_bool stop;           // Raised by the winner to cancel the others
+    atomic_int winner;          // Strategy index of the first finisher
+    struct timespec start;
+} PortfolioShared;
+
+typedef struct {
+    int index;
+    PortfolioStrategy strategy;
+    const Puzzle* source;
+    Puzzle* local;              // Private copy with relabelled regions
+    int to_original[MAX_N];     // Local region id -> original region id
+    SolverConfig config;
+    PortfolioShared* shared;
+    int restarts;
+    long long nodes_explored;
+    double wall_time;
+} PortfolioWorker;
+
+static const PortfolioStrategy STRATEGIES[] = {
+    {"index/raster",     PORTFOLIO_REGIONS_INDEX,    VALUE_ORDER_RASTER, 1, false},
+    {"smallest/lcv",     PORTFOLIO_REGIONS_SMALLEST, VALUE_ORDER_LCV,    1, false},
+    {"random/random",    PORTFOLIO_REGIONS_RANDOM,   VALUE_ORDER_RANDOM, 1, true},
+    {"index/lcv",        PORTFOLIO_REGIONS_INDEX,    VALUE_ORDER_LCV,    1, false},
+    {"smallest/random",  PORTFOLIO_REGIONS_SMALLEST, VALUE_ORDER_RANDOM, 2, true},
+    {"smallest/raster",  PORTFOLIO_REGIONS_SMALLEST, VALUE_ORDER_RASTER, 1, false},
+};
+
+#define STRATEGY_COUNT ((int)(sizeof(STRATEGIES) / sizeof(STRATEGIES[0])))
+
+PortfolioStrategy portfolio_strategy(int index) {
+    if (index < STRATEGY_COUNT) {
+        return STRATEGIES[index];
+    }
+
+    // Extra slots race further seeds of the fully random strategy
+    PortfolioStrategy strategy = STRATEGIES[2];
+    strategy.name = "random/random";
+    strategy.seed = (unsigned int)(index * 2654435761u);
+    return strategy;
+}
+
+static double seconds_since(const struct timespec* start) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)(now.tv_sec - start->tv_sec) + (double)(now.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+/*
+ * Copy the source puzzle, renumbering regions so the strategy's region order
+ * becomes 0..n-1 for solver_backtrack
+ */
+static void build_local_puzzle(PortfolioWorker* worker) {
+    const Puzzle* source = worker->source;
+    int n = source->n;
+    int order[MAX_N];
+
+    for (int i = 0; i < n; i++) {
+        order[i] = i;
+    }
+
+    if (worker->strategy.region_order == PORTFOLIO_REGIONS_SMALLEST) {
+        for (int i = 1; i < n; i++) {
+            int region = order[i];
+            int j = i - 1;
+            while (j >= 0 && source->region_size[order[j]] > source->region_size[region]) {
+                order[j + 1] = order[j];
+                j--;
+            }
+            order[j + 1] = region;
+        }
+    } else if (worker->strategy.region_order == PORTFOLIO_REGIONS_RANDOM) {
+        unsigned int state = worker->strategy.seed * 2891336453u + 1;
+        for (int i = n - 1; i > 0; i--) {
+            state = state * 1103515245u + 12345u;
+            int j = (int)((state >> 16) % (unsigned int)(i + 1));
+            int tmp = order[i];
+            order[i] = order[j];
+            order[j] = tmp;
+        }
+    }
+
+    int to_local[MAX_N];
+    for (int i = 0; i < n; i++) {
+        to_local[order[i]] = i;
+        worker->to_original[i] = order[i];
+    }
+
+    for (int row = 0; row < n; row++) {
+        for (int col = 0; col < n; col++) {
+            worker->local->regions[row][col] = to_local[source->regions[row][col]];
+        }
+    }
+    puzzle_build_region_lists(worker->local);
+}
+
+static void* portfolio_worker(void* arg) {
+    PortfolioWorker* worker = (PortfolioWorker*)arg;
+    PortfolioShared* shared = worker->shared;
+    int n = worker->source->n;
+
+    SolverConfig config = worker->config;
+    config.verbose = false;
+    config.cancel = &shared->stop;
+    config.value_order = worker->strategy.value_order;
+    config.seed = worker->strategy.seed;
+
+    bool restarts = worker->strategy.restarts && !config.find_all_solutions;
+    long budget = PORTFOLIO_RESTART_BASE;
+    bool finished = false;
+
+    while (!finished && !atomic_load(&shared->stop)) {
+        puzzle_reset(worker->local, n);
+        config.node_limit = restarts ? budget : 0;
+
+        solver_solve(worker->local, config);
+        SolverStats stats = solver_get_stats(worker->local);
+        worker->nodes_explored += stats.nodes_explored;
+
+        if (!stats.interrupted) {
+            finished = true;
+        } else if (restarts && !atomic_load(&shared->stop)) {
+            // Geometric restart schedule with a fresh seed each time
+            worker->restarts++;
+            budget *= 2;
+            config.seed = config.seed * 1664525u + 1013904223u;
+        } else {
+            break;
+        }
+    }
+
+    if (finished) {
+        int expected = -1;
+        if (atomic_compare_exchange_strong(&shared->winner, &expected, worker->index)) {
+            worker->wall_time = seconds_since(&shared->start);
+            atomic_store(&shared->stop, true);
+        }
+    }
+
+    return NULL;
+}
+
+bool portfolio_solve(Puzzle* puzzle, SolverConfig config, int threads, PortfolioResult* result) {
+    int n = puzzle_get_size(puzzle);
+    if (threads < 1) threads = 1;
+    if (threads > PORTFOLIO_MAX_THREADS) threads = PORTFOLIO_MAX_THREADS;
+
+    PortfolioShared shared;
+    atomic_init(&shared.stop, false);
+    atomic_init(&shared.winner, -1);
+    clock_gettime(CLOCK_MONOTONIC, &shared.start);
+
+    PortfolioWorker workers[PORTFOLIO_MAX_THREADS];
+    pthread_t handles[PORTFOLIO_MAX_THREADS];
+    int started = 0;
+
+    for (int i = 0; i < threads; i++) {
+        PortfolioWorker* worker = &workers[i];
+        memset(worker, 0, sizeof(*worker));
+        worker->index = i;
+        worker->strategy = portfolio_strategy(i);
+        worker->source = puzzle;
+        worker->config = config;
+        worker->shared = &shared;
+        worker->local = puzzle_create(n);
+        if (!worker->local) {
+            break;
+        }
+        build_local_puzzle(worker);
+
+        if (pthread_create(&handles[i], NULL, portfolio_worker, worker) != 0) {
+            puzzle_destroy(worker->local);
+            break;
+        }
+        started++;
+    }
+
+    for (int i = 0; i < started; i++) {
+        pthread_join(handles[i], NULL);
+    }
+
+    int winner = atomic_load(&shared.winner);
+    double wall_time = winner >= 0 ? workers[winner].wall_time : seconds_since(&shared.start);
+
+    // Copy the winner's answer back, translating region ids to the originals
+    puzzle_init(puzzle, n);
+    if (winner >= 0) {
+        PortfolioWorker* worker = &workers[winner];
+        const Puzzle* local = worker->local;
+
+        if (puzzle_has_solution(local)) {
+            for (int row = 0; row < n; row++) {
+                for (int col = 0; col < n; col++) {
+                    int cell = local->solution_board[row][col];
+                    puzzle_set_cell(puzzle, row, col, cell >= 0 ? worker->to_original[cell] : -1);
+                }
+            }
+            puzzle_save_solution(puzzle);
+            for (int row = 0; row < n; row++) {
+                for (int col = 0; col < n; col++) {
+                    puzzle_clear_cell(puzzle, row, col);
+                }
+            }
+        }
+        puzzle->solution_count = local->solution_count;
+    }
+
+    if (result) {
+        result->winner = winner;
+        result->winner_name = winner >= 0 ? workers[winner].strategy.name : NULL;
+        result->threads = started;
+        result->restarts = winner >= 0 ? workers[winner].restarts : 0;
+        result->nodes_explored = winner >= 0 ? workers[winner].nodes_explored : 0;
+        result->wall_time = wall_time;
+    }
+
+    for (int i = 0; i < started; i++) {
+        puzzle_destroy(workers[i].local);
+    }
+
+    if (config.verbose && winner >= 0) {
+        printf("Portfolio of %d strategies: '%s' won in %.6f seconds\n",
+               started, workers[winner].strategy.name, wall_time);
+        printf("Winner explored %lld nodes with %d restart(s)\n",
+               workers[winner].nodes_explored, workers[winner].restarts);
+        printf("Found %lld solution(s)\n", puzzle_get_solution_count(puzzle));
+    }
+
+    return puzzle_has_solution(puzzle);
+}
@@ -0,0 +1,42 @@
+#ifndef PORTFOLIO_H
+#define PORTFOLIO_H
+
+#include "puzzle.h"
+#include "solver.h"
+
+/* Most strategies raced at once */
+#define PORTFOLIO_MAX_THREADS 16
+
+/* Order in which a strategy visits the regions */
+typedef enum {
+    PORTFOLIO_REGIONS_INDEX,     // Region 0 first, as solver_backtrack does
+    PORTFOLIO_REGIONS_SMALLEST,  // Fewest cells first
+    PORTFOLIO_REGIONS_RANDOM     // Seeded shuffle
+} PortfolioRegionOrder;
+
+/* One solver configuration raced in the portfolio */
+typedef struct {
+    const char* name;
+    PortfolioRegionOrder region_order;
+    ValueOrder value_order;
+    unsigned int seed;
+    bool restarts;              // Re-seed with a growing node budget (first solution only)
+} PortfolioStrategy;
+
+/* Outcome of a portfolio race */
+typedef struct {
+    int winner;                 // Index of the strategy that finished first (-1 = none)
+    const char* winner_name;
+    int threads;
+    int restarts;               // Restarts performed by the winner
+    long long nodes_explored;   // Nodes explored by the winner
+    double wall_time;           // Seconds until the winner finished
+} PortfolioResult;
+
+/* Strategy raced on the given thread slot */
+PortfolioStrategy portfolio_strategy(int index);
+
+/* Race `threads` strategies on private copies of the puzzle; first finisher wins */
+bool portfolio_solve(Puzzle* puzzle, SolverConfig config, int threads, PortfolioResult* result);
+
+#endif
@@ -0,0 +1,223 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "progress.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+struct ProgressReporter {
+    SolverProgress* progress;
+    int interval_ms;
+    const char* status_path;
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+    bool stop;
+    struct timespec start;
+    struct timespec last;
+    long long last_nodes;
+};
+
+static double seconds_between(const struct timespec* from, const struct timespec* to) {
+    return (double)(to->tv_sec - from->tv_sec) + (double)(to->tv_nsec - from->tv_nsec) / 1e9;
+}
+
+void progress_counters_reset(SearchCounters* counters, long long solutions) {
+    atomic_store_explicit(&counters->nodes, 0, memory_order_relaxed);
+    atomic_store_explicit(&counters->solutions, solutions, memory_order_relaxed);
+    atomic_store_explicit(&counters->depth, 0, memory_order_relaxed);
+    for (int d = 0; d < MAX_N; d++) {
+        atomic_store_explicit(&counters->branch[d], 0, memory_order_relaxed);
+    }
+}
+
+void progress_init(SolverProgress* progress) {
+    pthread_mutex_init(&progress->lock, NULL);
+    progress->counters = NULL;
+    for (int d = 0; d < PROGRESS_TRACK_DEPTH; d++) {
+        progress->branch_size[d] = 0;
+    }
+    progress->final_nodes = 0;
+    progress->final_solutions = 0;
+}
+
+void progress_destroy(SolverProgress* progress) {
+    pthread_mutex_destroy(&progress->lock);
+}
+
+void progress_attach(SolverProgress* progress, const Puzzle* puzzle, const SearchCounters* counters) {
+    if (!progress) {
+        return;
+    }
+
+    pthread_mutex_lock(&progress->lock);
+    progress->counters = counters;
+    for (int d = 0; d < PROGRESS_TRACK_DEPTH; d++) {
+        progress->branch_size[d] = d < puzzle->n ? puzzle->region_size[d] : 0;
+    }
+    pthread_mutex_unlock(&progress->lock);
+}
+
+void progress_detach(SolverProgress* progress) {
+    if (!progress) {
+        return;
+    }
+
+    pthread_mutex_lock(&progress->lock);
+    if (progress->counters) {
+        progress->final_nodes = atomic_load_explicit(&progress->counters->nodes, memory_order_relaxed);
+        progress->final_solutions = atomic_load_explicit(&progress->counters->solutions,
+                                                         memory_order_relaxed);
+    }
+    progress->counters = NULL;
+    pthread_mutex_unlock(&progress->lock);
+}
+
+/*
+ * Estimated fraction of the search tree already finished, from the top-level
+ * branch positions
+ */
+static double sample_fraction(const SolverProgress* progress, int depth) {
+    const SearchCounters* counters = progress->counters;
+    double fraction = 0.0;
+    double scale = 1.0;
+
+    // Each level's finished siblings cover branch/size of its parent's share
+    for (int d = 0; d < depth && d < PROGRESS_TRACK_DEPTH; d++) {
+        int size = progress->branch_size[d];
+        int branch = atomic_load_explicit(&counters->branch[d], memory_order_relaxed);
+        if (size <= 0 || branch < 0 || branch >= size) break;
+
+        fraction += scale * (double)branch / size;
+        scale /= size;
+    }
+
+    return fraction;
+}
+
+/*
+ * Write one status line to stderr or the status file
+ */
+static void report(ProgressReporter* reporter, bool final) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    SolverProgress* progress = reporter->progress;
+    long long nodes;
+    long long solutions;
+    int depth = 0;
+    double fraction = final ? 1.0 : 0.0;
+
+    pthread_mutex_lock(&progress->lock);
+    const SearchCounters* counters = progress->counters;
+    if (counters) {
+        nodes = atomic_load_explicit(&counters->nodes, memory_order_relaxed);
+        solutions = atomic_load_explicit(&counters->solutions, memory_order_relaxed);
+        if (!final) {
+            depth = atomic_load_explicit(&counters->depth, memory_order_relaxed);
+            fraction = sample_fraction(progress, depth);
+        }
+    } else {
+        nodes = progress->final_nodes;
+        solutions = progress->final_solutions;
+    }
+    pthread_mutex_unlock(&progress->lock);
+
+    double interval = seconds_between(&reporter->last, &now);
+    double rate = interval > 0 ? (double)(nodes - reporter->last_nodes) / interval : 0.0;
+    reporter->last = now;
+    reporter->last_nodes = nodes;
+
+    // The status file is replaced by rename so readers never see a half-written line
+    FILE* out = stderr;
+    char tmp_path[4096];
+    if (reporter->status_path) {
+        if (snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", reporter->status_path) >=
+            (int)sizeof(tmp_path)) {
+            return;
+        }
+        out = fopen(tmp_path, "w");
+        if (!out) return;
+    }
+
+    fprintf(out, "[%8.1fs] %lld nodes (%.3g nodes/s), %lld solutions, depth %d, ~%.2f%% done%s\n",
+            seconds_between(&reporter->start, &now), nodes, rate, solutions, depth,
+            100.0 * fraction, final ? " (finished)" : "");
+
+    if (reporter->status_path) {
+        bool ok = !ferror(out);
+        ok = (fclose(out) == 0) && ok;
+        if (!ok || rename(tmp_path, reporter->status_path) != 0) {
+            remove(tmp_path);
+        }
+    }
+}
+
+static void* reporter_thread(void* arg) {
+    ProgressReporter* reporter = (ProgressReporter*)arg;
+
+    pthread_mutex_lock(&reporter->lock);
+    while (!reporter->stop) {
+        struct timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_sec += reporter->interval_ms / 1000;
+        deadline.tv_nsec += (long)(reporter->interval_ms % 1000) * 1000000L;
+        if (deadline.tv_nsec >= 1000000000L) {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000L;
+        }
+
+        pthread_cond_timedwait(&reporter->wake, &reporter->lock, &deadline);
+        if (!reporter->stop) {
+            report(reporter, false);
+        }
+    }
+    pthread_mutex_unlock(&reporter->lock);
+
+    return NULL;
+}
+
+ProgressReporter* progress_start(SolverProgress* progress, int interval_ms, const char* status_path) {
+    ProgressReporter* reporter = (ProgressReporter*)malloc(sizeof(ProgressReporter));
+    if (!reporter) {
+        return NULL;
+    }
+
+    reporter->progress = progress;
+    reporter->interval_ms = interval_ms > 0 ? interval_ms : 1000;
+    reporter->status_path = status_path;
+    reporter->stop = false;
+    clock_gettime(CLOCK_MONOTONIC, &reporter->start);
+    reporter->last = reporter->start;
+    reporter->last_nodes = 0;
+    pthread_mutex_init(&reporter->lock, NULL);
+    pthread_cond_init(&reporter->wake, NULL);
+
+    if (pthread_create(&reporter->thread, NULL, reporter_thread, reporter) != 0) {
+        pthread_mutex_destroy(&reporter->lock);
+        pthread_cond_destroy(&reporter->wake);
+        free(reporter);
+        return NULL;
+    }
+
+    return reporter;
+}
+
+void progress_stop(ProgressReporter* reporter) {
+    if (!reporter) {
+        return;
+    }
+
+    pthread_mutex_lock(&reporter->lock);
+    reporter->stop = true;
+    pthread_cond_signal(&reporter->wake);
+    pthread_mutex_unlock(&reporter->lock);
+    pthread_join(reporter->thread, NULL);
+
+    report(reporter, true);
+
+    pthread_mutex_destroy(&reporter->lock);
+    pthread_cond_destroy(&reporter->wake);
+    free(reporter);
+}
@@ -0,0 +1,56 @@
+#ifndef PROGRESS_H
+#define PROGRESS_H
+
+#include "puzzle.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+
+/* Top levels whose branch positions feed the done-fraction estimate */
+#define PROGRESS_TRACK_DEPTH 4
+
+/* Counters a search keeps in its own state, every store relaxed and with no
+ * read-modify-write; the reporter reads nothing else */
+typedef struct SearchCounters {
+    atomic_llong nodes;
+    atomic_llong solutions;
+    atomic_int depth;                   // Levels holding a queen
+    atomic_int branch[MAX_N];           // Cell index taken at each level
+} SearchCounters;
+
+/* Where the running search keeps its counters. The search publishes them
+ * with progress_attach and never writes here itself; the reporter samples
+ * them in place. */
+typedef struct SolverProgress {
+    pthread_mutex_t lock;               // Held by attach, detach and each sample
+    const SearchCounters* counters;     // NULL = not attached
+    int branch_size[PROGRESS_TRACK_DEPTH];  // Cells in each top level, copied at attach
+    long long final_nodes;              // Left by the last detach
+    long long final_solutions;
+} SolverProgress;
+
+typedef struct ProgressReporter ProgressReporter;
+
+/* Zero a search's counters, starting from solutions already found */
+void progress_counters_reset(SearchCounters* counters, long long solutions);
+
+/* Start with nothing attached */
+void progress_init(SolverProgress* progress);
+
+/* Release the lock */
+void progress_destroy(SolverProgress* progress);
+
+/* Publish a search's counters; progress may be NULL */
+void progress_attach(SolverProgress* progress, const Puzzle* puzzle, const SearchCounters* counters);
+
+/* Withdraw them before they go out of scope, keeping the final totals */
+void progress_detach(SolverProgress* progress);
+
+/* Start a thread that samples the counters every interval_ms and reports to
+ * stderr, or replaces status_path when it is not NULL */
+ProgressReporter* progress_start(SolverProgress* progress, int interval_ms, const char* status_path);
+
+/* Print a final report and stop the sampling thread */
+void progress_stop(ProgressReporter* reporter);
+
+#endif
@@ -27,6 +27,19 @@ void puzzle_init(Puzzle* puzzle, int n) {
     memset(puzzle->col_used, false, sizeof(puzzle->col_used));
 }
 
+void puzzle_reset(Puzzle* puzzle, int n) {
+    puzzle->n = n;
+    puzzle->solution_count = 0;
+    puzzle->found = false;
+    
+    for (int row = 0; row < n; row++) {
+        memset(puzzle->board[row], -1, sizeof(int) * n);
+        memset(puzzle->solution_board[row], -1, sizeof(int) * n);
+    }
+    memset(puzzle->row_used, false, sizeof(bool) * n);
+    memset(puzzle->col_used, false, sizeof(bool) * n);
+}
+
 int puzzle_get_size(const Puzzle* puzzle) {
     return puzzle->n;
 }
@@ -49,7 +62,7 @@ bool puzzle_has_solution(const Puzzle* puzzle) {
     return puzzle->found;
 }
 
-int puzzle_get_solution_count(const Puzzle* puzzle) {
+long long puzzle_get_solution_count(const Puzzle* puzzle) {
     return puzzle->solution_count;
 }
 
@@ -64,7 +77,7 @@ void puzzle_clear_cell(Puzzle* puzzle, int row, int col) {
 }
 
 void puzzle_save_solution(Puzzle* puzzle) {
-    memcpy(puzzle->solution_board, puzzle->board, sizeof(puzzle->board));
+    memcpy(puzzle->solution_board, puzzle->board, sizeof(puzzle->board[0]) * puzzle->n);
     puzzle->found = true;
     puzzle->solution_count++;
 }
@@ -12,7 +12,7 @@ typedef struct {
     int regions[MAX_N][MAX_N];          // Region ID for each cell
     bool row_used[MAX_N];               // Track used rows
     bool col_used[MAX_N];               // Track used columns
-    int solution_count;                 // Number of solutions found
+    long long solution_count;           // Number of solutions found
     bool found;                         // Flag for first solution found
     
     // Optimization: pre-computed region cell lists
@@ -30,12 +30,16 @@ void puzzle_destroy(Puzzle* puzzle);
 /* Initialize/reset puzzle state */
 void puzzle_init(Puzzle* puzzle, int n);
 
+/* Reset for a new solve of size n, touching only the n×n area. The puzzle must
+ * have been through puzzle_init once; cells outside n×n are left as they were. */
+void puzzle_reset(Puzzle* puzzle, int n);
+
 /* Getter methods */
 int puzzle_get_size(const Puzzle* puzzle);
 int puzzle_get_cell(const Puzzle* puzzle, int row, int col);
 int puzzle_get_region(const Puzzle* puzzle, int row, int col);
 bool puzzle_has_solution(const Puzzle* puzzle);
-int puzzle_get_solution_count(const Puzzle* puzzle);
+long long puzzle_get_solution_count(const Puzzle* puzzle);
 
 /* Setter methods */
 void puzzle_set_cell(Puzzle* puzzle, int row, int col, int value);
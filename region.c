@@ -1,9 +1,34 @@
 #include "region.h"
+#include "display.h"
+#include "editcheck.h"
 #include <string.h>
 #include <stdlib.h>
 #include <time.h>
 #include <stdio.h>
 
+// Search nodes per solvability check in the interactive editor (under ~0.1 s)
+#define REGION_EDIT_NODE_BUDGET 1000000L
+
+// Growth offers: four per claimed cell, each re-queued at most once
+#define REGION_HEAP_SIZE(n) (8 * (n) * (n))
+
+// Set once the generator has been seeded, by region_seed or from the clock
+static bool g_seed_initialized = false;
+
+// REGION_BALANCED shape targets
+static int g_shape_slack = 0;
+static int g_shape_roughness = 60;
+
+void region_set_shape(int slack_percent, int roughness_percent) {
+    g_shape_slack = slack_percent < 0 ? 0 : slack_percent;
+    g_shape_roughness = roughness_percent < 0 ? 0 : roughness_percent > 100 ? 100 : roughness_percent;
+}
+
+void region_seed(unsigned int seed) {
+    srand(seed);
+    g_seed_initialized = true;
+}
+
 void region_load_custom(Puzzle* puzzle, int regions[][MAX_N]) {
     int n = puzzle_get_size(puzzle);
     for (int row = 0; row < n; row++) {
@@ -18,6 +43,9 @@ void region_generate(Puzzle* puzzle, RegionType type) {
         case REGION_CONTINUOUS:
             region_generate_continuous(puzzle);
             break;
+        case REGION_BALANCED:
+            region_generate_balanced(puzzle);
+            break;
         case REGION_INTERACTIVE:
             region_create_interactive(puzzle);
             break;
@@ -28,52 +56,19 @@ void region_generate(Puzzle* puzzle, RegionType type) {
 }
 
 bool region_validate(const Puzzle* puzzle) {
-    int n = puzzle_get_size(puzzle);
-    int region_count[MAX_N] = {0};
-    int max_region = -1;
-    
-    // Count cells in each region
-    for (int row = 0; row < n; row++) {
-        for (int col = 0; col < n; col++) {
-            int region = puzzle_get_region(puzzle, row, col);
-            if (region < 0 || region >= MAX_N) {
-                return false;
-            }
-            region_count[region]++;
-            if (region > max_region) {
-                max_region = region;
-            }
-        }
-    }
-    
-    // Check that we have exactly n regions
-    if (max_region != n - 1) {
-        return false;
-    }
-    
-    // Each region should have at least one cell
-    for (int i = 0; i < n; i++) {
-        if (region_count[i] == 0) {
-            return false;
-        }
-    }
-    
-    return true;
+    RegionReport report;
+    return region_analyze(puzzle, &report);
 }
 
 int region_count_cells(const Puzzle* puzzle, int region_id) {
-    int n = puzzle_get_size(puzzle);
-    int count = 0;
-    
-    for (int row = 0; row < n; row++) {
-        for (int col = 0; col < n; col++) {
-            if (puzzle_get_region(puzzle, row, col) == region_id) {
-                count++;
-            }
-        }
+    if (region_id < 0 || region_id >= puzzle_get_size(puzzle)) {
+        return 0;
     }
     
-    return count;
+    // Sizes come from the same single pass that validates the map
+    RegionReport report;
+    region_analyze(puzzle, &report);
+    return report.size[region_id];
 }
 
 // 4-directional neighbors (for connectivity)
@@ -194,11 +189,10 @@ void region_generate_continuous(Puzzle* puzzle) {
         }
     }
     
-    // Seed random number generator with current time
-    static int seed_initialized = 0;
-    if (!seed_initialized) {
+    // Seed random number generator with current time unless region_seed chose one
+    if (!g_seed_initialized) {
         srand((unsigned int)time(NULL));
-        seed_initialized = 1;
+        g_seed_initialized = true;
     }
     
     // Calculate target size for each region (with some variation)
@@ -323,74 +317,318 @@ void region_generate_continuous(Puzzle* puzzle) {
     }
 }
 
+/* A cell offered to a region, cheapest first */
+typedef struct {
+    long key;
+    short row, col;
+    unsigned char region;
+    bool penalized;         // Already re-queued once because its region was full
+} GrowthEntry;
+
+typedef struct {
+    GrowthEntry* entries;   // REGION_HEAP_SIZE(n) slots
+    int count;
+} GrowthHeap;
+
+static void heap_push(GrowthHeap* heap, GrowthEntry entry) {
+    int i = heap->count++;
+    while (i > 0) {
+        int parent = (i - 1) / 2;
+        if (heap->entries[parent].key <= entry.key) break;
+        heap->entries[i] = heap->entries[parent];
+        i = parent;
+    }
+    heap->entries[i] = entry;
+}
+
+static GrowthEntry heap_pop(GrowthHeap* heap) {
+    GrowthEntry top = heap->entries[0];
+    GrowthEntry last = heap->entries[--heap->count];
+    int i = 0;
+    for (;;) {
+        int child = 2 * i + 1;
+        if (child >= heap->count) break;
+        if (child + 1 < heap->count && heap->entries[child + 1].key < heap->entries[child].key) {
+            child++;
+        }
+        if (last.key <= heap->entries[child].key) break;
+        heap->entries[i] = heap->entries[child];
+        i = child;
+    }
+    if (heap->count > 0) {
+        heap->entries[i] = last;
+    }
+    return top;
+}
+
 /*
- * Verify that all regions are continuous/connected
+ * Seeds on a jittered grid of equal areas: about sqrt(n) bands, where a band of
+ * c rows holds c regions side by side. Ids are shuffled and the grid is
+ * transposed half the time, so maps do not all read the same way. Jitter
+ * keeps each seed inside its own grid cell. Returns false unless every region
+ * got a distinct seed on the board.
  */
-bool region_verify_continuous(const Puzzle* puzzle) {
+static bool place_balanced_seeds(int n, int* seed_row, int* seed_col) {
+    int ids[MAX_N];
+    for (int i = 0; i < n; i++) {
+        ids[i] = i;
+    }
+    for (int i = n - 1; i > 0; i--) {
+        int j = rand() % (i + 1);
+        int swap = ids[i];
+        ids[i] = ids[j];
+        ids[j] = swap;
+    }
+
+    int bands = 1;
+    while ((bands + 1) * (bands + 1) <= n) bands++;
+    bool transpose = rand() % 2;
+
+    int next = 0, top = 0;
+    for (int band = 0; band < bands; band++) {
+        int count = n / bands + (band < n % bands);
+        for (int i = 0; i < count; i++) {
+            int left = i * n / count, right = (i + 1) * n / count;
+            int height = count, width = right - left;
+            int jitter_row = height * g_shape_roughness / 200;
+            int jitter_col = width * g_shape_roughness / 200;
+            if (jitter_row > (height - 1) / 2) jitter_row = (height - 1) / 2;
+            if (jitter_col > (width - 1) / 2) jitter_col = (width - 1) / 2;
+            int row = top + height / 2 + (jitter_row > 0 ? rand() % (2 * jitter_row + 1) - jitter_row : 0);
+            int col = left + width / 2 + (jitter_col > 0 ? rand() % (2 * jitter_col + 1) - jitter_col : 0);
+            int region = ids[next++];
+            seed_row[region] = transpose ? col : row;
+            seed_col[region] = transpose ? row : col;
+        }
+        top += count;
+    }
+
+    bool taken[MAX_N][MAX_N] = {{false}};
+    for (int region = 0; region < n; region++) {
+        int row = seed_row[region], col = seed_col[region];
+        if (region >= next || row < 0 || row >= n || col < 0 || col >= n || taken[row][col]) {
+            return false;
+        }
+        taken[row][col] = true;
+    }
+    return true;
+}
+
+/*
+ * Squared distance to the seed, stretched by random noise of up to
+ * 4 * roughness percent so boundaries wander without cutting seeds off
+ */
+static long growth_key(int row, int col, int seed_row, int seed_col) {
+    long dr = row - seed_row, dc = col - seed_col;
+    return (dr * dr + dc * dc) * (100 + rand() % (4 * g_shape_roughness + 1));
+}
+
+static void offer_neighbours(GrowthHeap* heap, int regions[][MAX_N], int n, int region,
+                             int row, int col, const int* seed_row, const int* seed_col) {
+    for (int d = 0; d < 4; d++) {
+        int nr = row + DX4[d];
+        int nc = col + DY4[d];
+        if (nr >= 0 && nr < n && nc >= 0 && nc < n && regions[nr][nc] == -1) {
+            GrowthEntry entry = {growth_key(nr, nc, seed_row[region], seed_col[region]),
+                                 (short)nr, (short)nc, (unsigned char)region, false};
+            heap_push(heap, entry);
+        }
+    }
+}
+
+void region_generate_balanced(Puzzle* puzzle) {
     int n = puzzle_get_size(puzzle);
+    int regions[MAX_N][MAX_N];
+    int seed_row[MAX_N], seed_col[MAX_N], size[MAX_N];
+    GrowthHeap heap;
+
+    heap.entries = (GrowthEntry*)malloc(sizeof(GrowthEntry) * REGION_HEAP_SIZE(n));
+    if (!heap.entries) {
+        // Out of memory: fall back to the plain continuous generator
+        region_generate_continuous(puzzle);
+        return;
+    }
+
+    if (!g_seed_initialized) {
+        srand((unsigned int)time(NULL));
+        g_seed_initialized = true;
+    }
+
+    for (int row = 0; row < n; row++) {
+        for (int col = 0; col < n; col++) {
+            regions[row][col] = -1;
+        }
+    }
+    if (!place_balanced_seeds(n, seed_row, seed_col)) {
+        // Not reachable with the clamped jitter; the diagonal is always valid
+        for (int region = 0; region < n; region++) {
+            seed_row[region] = seed_col[region] = region;
+        }
+    }
+    for (int region = 0; region < n; region++) {
+        regions[seed_row[region]][seed_col[region]] = region;
+        size[region] = 1;
+    }
+
+    // Offer the seeds' neighbours, then keep claiming the cheapest offer
+    long penalty = 2L * n * n * 500 + 1;
+    int target = (n * (100 + g_shape_slack) + 99) / 100;
+    heap.count = 0;
+    for (int region = 0; region < n; region++) {
+        offer_neighbours(&heap, regions, n, region, seed_row[region], seed_col[region],
+                         seed_row, seed_col);
+    }
+
+    while (heap.count > 0) {
+        GrowthEntry entry = heap_pop(&heap);
+        if (regions[entry.row][entry.col] != -1) {
+            continue;
+        }
+
+        // A full region only gets the cell if no other region claims it first
+        if (size[entry.region] >= target && !entry.penalized) {
+            entry.key += penalty;
+            entry.penalized = true;
+            heap_push(&heap, entry);
+            continue;
+        }
+
+        regions[entry.row][entry.col] = entry.region;
+        size[entry.region]++;
+        offer_neighbours(&heap, regions, n, entry.region, entry.row, entry.col,
+                                      seed_row, seed_col);
+    }
+    free(heap.entries);
+
+    for (int row = 0; row < n; row++) {
+        for (int col = 0; col < n; col++) {
+            puzzle->regions[row][col] = regions[row][col];
+        }
+    }
+}
+
+/*
+ * Union-find root with path halving
+ */
+static int find_root(int* parent, int cell) {
+    while (parent[cell] != cell) {
+        parent[cell] = parent[parent[cell]];
+        cell = parent[cell];
+    }
+    return cell;
+}
+
+static void join_cells(int* parent, int a, int b) {
+    int root_a = find_root(parent, a);
+    int root_b = find_root(parent, b);
+    if (root_a != root_b) {
+        parent[root_a] = root_b;
+    }
+}
+
+bool region_analyze(const Puzzle* puzzle, RegionReport* report) {
+    int n = puzzle_get_size(puzzle);
+    int parent[MAX_N * MAX_N];
     
-    for (int region_id = 0; region_id < n; region_id++) {
-        // Find first cell of this region
-        int start_row = -1, start_col = -1;
-        int total_cells = 0;
-        
-        for (int row = 0; row < n && start_row == -1; row++) {
-            for (int col = 0; col < n && start_col == -1; col++) {
-                if (puzzle_get_region(puzzle, row, col) == region_id) {
-                    start_row = row;
-                    start_col = col;
+    report->valid = true;
+    report->continuous = true;
+    report->bad_row = -1;
+    report->bad_col = -1;
+    report->first_empty = -1;
+    report->first_split = -1;
+    for (int i = 0; i < MAX_N; i++) {
+        report->size[i] = 0;
+        report->components[i] = 0;
+    }
+    
+    // Count cells and join each cell with its right and lower neighbour of the same region
+    for (int row = 0; row < n; row++) {
+        for (int col = 0; col < n; col++) {
+            int cell = row * n + col;
+            int region = puzzle_get_region(puzzle, row, col);
+            parent[cell] = cell;
+            
+            if (region < 0 || region >= n) {
+                if (report->bad_row < 0) {
+                    report->bad_row = row;
+                    report->bad_col = col;
                 }
+                continue;
+            }
+            report->size[region]++;
+            
+            if (col > 0 && puzzle_get_region(puzzle, row, col - 1) == region) {
+                join_cells(parent, cell, cell - 1);
+            }
+            if (row > 0 && puzzle_get_region(puzzle, row - 1, col) == region) {
+                join_cells(parent, cell, cell - n);
             }
         }
-        
-        if (start_row == -1) continue;
-        
-        // Count total cells in this region
-        for (int row = 0; row < n; row++) {
-            for (int col = 0; col < n; col++) {
-                if (puzzle_get_region(puzzle, row, col) == region_id) {
-                    total_cells++;
-                }
+    }
+    
+    // Each root is one piece of its region
+    for (int row = 0; row < n; row++) {
+        for (int col = 0; col < n; col++) {
+            int cell = row * n + col;
+            int region = puzzle_get_region(puzzle, row, col);
+            if (region >= 0 && region < n && find_root(parent, cell) == cell) {
+                report->components[region]++;
             }
         }
-        
-        // DFS to check connectivity
-        bool visited[MAX_N][MAX_N] = {{false}};
-        int stack_r[MAX_N * MAX_N];
-        int stack_c[MAX_N * MAX_N];
-        int stack_top = 0;
-        
-        stack_r[stack_top] = start_row;
-        stack_c[stack_top] = start_col;
-        stack_top++;
-        visited[start_row][start_col] = true;
-        
-        int connected_count = 1;
-        
-        while (stack_top > 0) {
-            stack_top--;
-            int row = stack_r[stack_top];
-            int col = stack_c[stack_top];
-            
-            for (int d = 0; d < 4; d++) {
-                int nr = row + DX4[d];
-                int nc = col + DY4[d];
-                
-                if (nr >= 0 && nr < n && nc >= 0 && nc < n && 
-                    !visited[nr][nc] && 
-                    puzzle_get_region(puzzle, nr, nc) == region_id) {
-                    
-                    visited[nr][nc] = true;
-                    stack_r[stack_top] = nr;
-                    stack_c[stack_top] = nc;
-                    stack_top++;
-                    connected_count++;
-                }
+    }
+    
+    for (int region = 0; region < n; region++) {
+        if (report->size[region] == 0 && report->first_empty < 0) {
+            report->first_empty = region;
+        }
+        if (report->components[region] > 1) {
+            report->continuous = false;
+            if (report->first_split < 0) {
+                report->first_split = region;
             }
         }
-        
-        if (connected_count != total_cells) {
-            return false;
+    }
+    
+    report->valid = report->bad_row < 0 && report->first_empty < 0;
+    return report->valid;
+}
+
+/*
+ * Verify that all regions are continuous/connected
+ */
+bool region_verify_continuous(const Puzzle* puzzle) {
+    RegionReport report;
+    region_analyze(puzzle, &report);
+    return report.continuous;
+}
+
+bool region_write_map(FILE* file, const Puzzle* puzzle) {
+    int n = puzzle_get_size(puzzle);
+    
+    fprintf(file, "%d\n", n);
+    for (int row = 0; row < n; row++) {
+        for (int col = 0; col < n; col++) {
+            fprintf(file, col + 1 < n ? "%d " : "%d\n", puzzle_get_region(puzzle, row, col));
+        }
+    }
+    
+    return !ferror(file);
+}
+
+bool region_read_map(FILE* file, Puzzle* puzzle) {
+    int n;
+    if (fscanf(file, "%d", &n) != 1 || n < 1 || n > MAX_N) {
+        return false;
+    }
+    
+    puzzle_reset(puzzle, n);
+    for (int row = 0; row < n; row++) {
+        for (int col = 0; col < n; col++) {
+            int region;
+            if (fscanf(file, "%d", &region) != 1 || region < 0 || region >= n) {
+                return false;
+            }
+            puzzle->regions[row][col] = region;
         }
     }
     
@@ -421,20 +659,19 @@ void region_create_interactive(Puzzle* puzzle) {
     int cells_assigned = 0;
     char cmd[100];
     
+    // Re-check solvability after every assignment, with open cells as wildcards
+    EditCheck check;
+    editcheck_init(&check, puzzle, REGION_EDIT_NODE_BUDGET);
+    
     while (cells_assigned < n * n) {
         // Show current state
-        printf("\nCurrent regions (%d/%d cells assigned):\n", cells_assigned, n * n);
-        for (int row = 0; row < n; row++) {
-            for (int col = 0; col < n; col++) {
-                int r = puzzle_get_region(puzzle, row, col);
-                if (r == -1) {
-                    printf(". ");
-                } else {
-                    printf("%d ", r);
-                }
-            }
-            printf("\n");
+        printf("\n%d/%d cells assigned, map is %s", cells_assigned, n * n,
+               editcheck_describe(&check));
+        if (check.nodes > 0) {
+            printf(" (%ld nodes)", check.nodes);
         }
+        printf("\n");
+        display_regions(puzzle);
         
         printf("\nCommand: ");
         if (!fgets(cmd, sizeof(cmd), stdin)) break;
@@ -455,6 +692,7 @@ void region_create_interactive(Puzzle* puzzle) {
                                 puzzle->regions[nr][nc] != -1) {
                                 puzzle->regions[row][col] = puzzle->regions[nr][nc];
                                 cells_assigned++;
+                                editcheck_assign(&check, row, col);
                                 break;
                             }
                         }
@@ -469,6 +707,7 @@ void region_create_interactive(Puzzle* puzzle) {
                     if (puzzle->regions[row][col] == -1) {
                         puzzle->regions[row][col] = region;
                         cells_assigned++;
+                        editcheck_assign(&check, row, col);
                     } else {
                         printf("Cell already assigned!\n");
                     }
@@ -2,10 +2,12 @@
 #define REGION_H
 
 #include "puzzle.h"
+#include <stdio.h>
 
 /* Region generation strategies */
 typedef enum {
     REGION_CONTINUOUS,  // Continuous irregular regions (LINKEDIN-LIKE)
+    REGION_BALANCED,    // All regions grown together to about n cells each
     REGION_CUSTOM,      // Load from custom data
     REGION_INTERACTIVE  // Interactive creation
 } RegionType;
@@ -13,6 +15,29 @@ typedef enum {
 /* Load custom regions from 2D array */
 void region_load_custom(Puzzle* puzzle, int regions[][MAX_N]);
 
+/* Result of one union-find pass over the region map */
+typedef struct {
+    bool valid;                 // Every id is in 0..n-1 and every region has a cell
+    bool continuous;            // Every region is a single 4-connected component
+    int size[MAX_N];            // Cells in each region
+    int components[MAX_N];      // 4-connected pieces of each region
+    int bad_row, bad_col;       // First cell with an out-of-range id (-1 = none)
+    int first_empty;            // First region without cells (-1 = none)
+    int first_split;            // First region with more than one piece (-1 = none)
+} RegionReport;
+
+/* Label connected components with union-find in one pass over the cells and
+ * fill in sizes, piece counts and the first problem found. Returns report->valid. */
+bool region_analyze(const Puzzle* puzzle, RegionReport* report);
+
+/* Seed region generation so maps are reproducible (default: seeded from the clock) */
+void region_seed(unsigned int seed);
+
+/* Shape targets for REGION_BALANCED: a region stops being preferred once it has
+ * n * (100 + slack) / 100 cells; roughness 0 grows round blobs, 100 grows
+ * ragged ones (default 0 and 60) */
+void region_set_shape(int slack_percent, int roughness_percent);
+
 /* Generate regions based on type */
 void region_generate(Puzzle* puzzle, RegionType type);
 
@@ -25,9 +50,20 @@ int region_count_cells(const Puzzle* puzzle, int region_id);
 /* Generate continuous irregular regions (LINKEDIN-LIKE) - Works for any N×N board */
 void region_generate_continuous(Puzzle* puzzle);
 
+/* Seed all n regions spread over the board, then grow them together through one
+ * priority queue keyed on distance to the seed. Every cell is claimed by a
+ * neighbouring region, so regions are continuous without repair passes. O(n^2 log n). */
+void region_generate_balanced(Puzzle* puzzle);
+
 /* Verify that all regions are continuous/connected */
 bool region_verify_continuous(const Puzzle* puzzle);
 
+/* Write the region map as text: board size, then one row of region ids per line */
+bool region_write_map(FILE* file, const Puzzle* puzzle);
+
+/* Read a region map written by region_write_map, resetting the (initialised) puzzle to its size */
+bool region_read_map(FILE* file, Puzzle* puzzle);
+
 /* Interactive region creator */
 void region_create_interactive(Puzzle* puzzle);
 
@@ -0,0 +1,301 @@
+#include "regionedit.h"
+#include <string.h>
+
+// 8-neighbour ring in circular order; even entries are the 4-neighbours
+static const int RING_DR[] = {-1, -1, 0, 1, 1, 1, 0, -1};
+static const int RING_DC[] = {0, 1, 1, 1, 0, -1, -1, -1};
+
+static const int DR4[] = {-1, 0, 1, 0};
+static const int DC4[] = {0, 1, 0, -1};
+
+static inline bool in_region(const Puzzle* puzzle, int row, int col, int region) {
+    int n = puzzle->n;
+    return row >= 0 && row < n && col >= 0 && col < n && puzzle->regions[row][col] == region;
+}
+
+static void set_connected(RegionEditor* editor, int region, bool connected) {
+    if (editor->connected[region] != connected) {
+        editor->split_regions += connected ? -1 : 1;
+        editor->connected[region] = connected;
+    }
+}
+
+/*
+ * Flood fill from the region's first listed cell; connected if it reaches every cell
+ */
+static bool flood_connected(RegionEditor* editor, int region) {
+    Puzzle* puzzle = editor->puzzle;
+    int size = puzzle->region_size[region];
+    if (size <= 1) {
+        return true;
+    }
+
+    int stamp = ++editor->visit_stamp;
+    int queue_row[MAX_N * MAX_N];
+    int queue_col[MAX_N * MAX_N];
+    int head = 0, tail = 0;
+
+    queue_row[tail] = puzzle->region_cells_row[region][0];
+    queue_col[tail] = puzzle->region_cells_col[region][0];
+    editor->visit[queue_row[tail]][queue_col[tail]] = stamp;
+    tail++;
+
+    while (head < tail) {
+        int row = queue_row[head];
+        int col = queue_col[head];
+        head++;
+        for (int d = 0; d < 4; d++) {
+            int nr = row + DR4[d];
+            int nc = col + DC4[d];
+            if (in_region(puzzle, nr, nc, region) && editor->visit[nr][nc] != stamp) {
+                editor->visit[nr][nc] = stamp;
+                queue_row[tail] = nr;
+                queue_col[tail] = nc;
+                tail++;
+            }
+        }
+    }
+
+    return tail == size;
+}
+
+/*
+ * Removing (row, col) keeps region connected when its region neighbours form a
+ * single run around the 8-ring that touches a 4-neighbour
+ */
+static bool removal_is_local(const Puzzle* puzzle, int row, int col, int region) {
+    bool in[8];
+    for (int i = 0; i < 8; i++) {
+        in[i] = in_region(puzzle, row + RING_DR[i], col + RING_DC[i], region);
+    }
+
+    // Start just after a ring cell outside the region; a full ring is one run
+    int start = 0;
+    while (start < 8 && in[start]) start++;
+    if (start == 8) return true;
+
+    int runs = 0;
+    bool in_run = false, run_has_edge = false;
+    for (int k = 1; k <= 8; k++) {
+        int i = (start + k) % 8;
+        if (in[i]) {
+            if (!in_run) {
+                in_run = true;
+                run_has_edge = false;
+            }
+            run_has_edge = run_has_edge || (i % 2 == 0);
+        } else if (in_run) {
+            in_run = false;
+            runs += run_has_edge;
+        }
+    }
+    return runs <= 1;
+}
+
+static bool touches_region(const Puzzle* puzzle, int row, int col, int region) {
+    for (int d = 0; d < 4; d++) {
+        if (in_region(puzzle, row + DR4[d], col + DC4[d], region)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/*
+ * Move a cell between region lists and update counts and masks; no connectivity
+ */
+static void transfer_cell(RegionEditor* editor, int row, int col, int to) {
+    Puzzle* puzzle = editor->puzzle;
+    int from = puzzle->regions[row][col];
+
+    // Swap-remove from the old region's list
+    int index = editor->position[row][col];
+    int last = --puzzle->region_size[from];
+    int moved_row = puzzle->region_cells_row[from][last];
+    int moved_col = puzzle->region_cells_col[from][last];
+    puzzle->region_cells_row[from][index] = moved_row;
+    puzzle->region_cells_col[from][index] = moved_col;
+    editor->position[moved_row][moved_col] = index;
+
+    if (--editor->row_cells[from][row] == 0) editor->row_mask[from] &= ~(1u << row);
+    if (--editor->col_cells[from][col] == 0) editor->col_mask[from] &= ~(1u << col);
+    if (last == 0) editor->empty_regions++;
+
+    // Append to the new region's list
+    int size = puzzle->region_size[to]++;
+    puzzle->region_cells_row[to][size] = row;
+    puzzle->region_cells_col[to][size] = col;
+    editor->position[row][col] = size;
+
+    editor->row_cells[to][row]++;
+    editor->col_cells[to][col]++;
+    editor->row_mask[to] |= 1u << row;
+    editor->col_mask[to] |= 1u << col;
+    if (size == 0) editor->empty_regions--;
+
+    puzzle->regions[row][col] = to;
+}
+
+/*
+ * Any earlier solution belongs to the old map
+ */
+static void invalidate_solutions(Puzzle* puzzle) {
+    puzzle->found = false;
+    puzzle->solution_count = 0;
+}
+
+void region_edit_begin(RegionEditor* editor, Puzzle* puzzle) {
+    int n = puzzle->n;
+
+    editor->puzzle = puzzle;
+    memset(editor->row_cells, 0, sizeof(editor->row_cells));
+    memset(editor->col_cells, 0, sizeof(editor->col_cells));
+    memset(editor->visit, 0, sizeof(editor->visit));
+    editor->visit_stamp = 0;
+    editor->split_regions = 0;
+    editor->empty_regions = 0;
+
+    puzzle_build_region_lists(puzzle);
+
+    for (int region = 0; region < n; region++) {
+        editor->row_mask[region] = 0;
+        editor->col_mask[region] = 0;
+        for (int i = 0; i < puzzle->region_size[region]; i++) {
+            int row = puzzle->region_cells_row[region][i];
+            int col = puzzle->region_cells_col[region][i];
+            editor->position[row][col] = i;
+            editor->row_cells[region][row]++;
+            editor->col_cells[region][col]++;
+            editor->row_mask[region] |= 1u << row;
+            editor->col_mask[region] |= 1u << col;
+        }
+
+        editor->connected[region] = true;
+        set_connected(editor, region, flood_connected(editor, region));
+        if (puzzle->region_size[region] == 0) {
+            editor->empty_regions++;
+        }
+    }
+}
+
+bool region_edit_move(RegionEditor* editor, int row, int col, int region) {
+    Puzzle* puzzle = editor->puzzle;
+    int n = puzzle->n;
+    if (row < 0 || row >= n || col < 0 || col >= n || region < 0 || region >= n) {
+        return false;
+    }
+
+    int from = puzzle->regions[row][col];
+    if (from == region) {
+        return true;
+    }
+
+    bool to_was_empty = puzzle->region_size[region] == 0;
+    transfer_cell(editor, row, col, region);
+    invalidate_solutions(puzzle);
+
+    // The old region can only split if the cell joined otherwise separate neighbours
+    if (!editor->connected[from] || !removal_is_local(puzzle, row, col, from)) {
+        set_connected(editor, from, flood_connected(editor, from));
+    }
+
+    // The new region stays whole if the cell touches it; a split region may have been rejoined
+    if (to_was_empty) {
+        set_connected(editor, region, true);
+    } else if (editor->connected[region]) {
+        set_connected(editor, region, touches_region(puzzle, row, col, region));
+    } else {
+        set_connected(editor, region, flood_connected(editor, region));
+    }
+
+    return true;
+}
+
+bool region_edit_swap(RegionEditor* editor, int row1, int col1, int row2, int col2) {
+    Puzzle* puzzle = editor->puzzle;
+    int n = puzzle->n;
+    if (row1 < 0 || row1 >= n || col1 < 0 || col1 >= n ||
+        row2 < 0 || row2 >= n || col2 < 0 || col2 >= n) {
+        return false;
+    }
+
+    int first = puzzle->regions[row1][col1];
+    int second = puzzle->regions[row2][col2];
+    return region_edit_move(editor, row1, col1, second) &&
+           region_edit_move(editor, row2, col2, first);
+}
+
+int region_edit_merge(RegionEditor* editor, int keep, int absorb) {
+    Puzzle* puzzle = editor->puzzle;
+    int n = puzzle->n;
+    if (keep < 0 || keep >= n || absorb < 0 || absorb >= n || keep == absorb) {
+        return 0;
+    }
+
+    int moved = 0;
+    while (puzzle->region_size[absorb] > 0) {
+        int last = puzzle->region_size[absorb] - 1;
+        transfer_cell(editor, puzzle->region_cells_row[absorb][last],
+                      puzzle->region_cells_col[absorb][last], keep);
+        moved++;
+    }
+    invalidate_solutions(puzzle);
+
+    set_connected(editor, absorb, true);
+    set_connected(editor, keep, flood_connected(editor, keep));
+    return moved;
+}
+
+int region_edit_split(RegionEditor* editor, int region, int row, int col, int target) {
+    Puzzle* puzzle = editor->puzzle;
+    int n = puzzle->n;
+    if (region < 0 || region >= n || target < 0 || target >= n || region == target ||
+        puzzle->region_size[target] != 0 || puzzle->region_size[region] < 2 ||
+        !in_region(puzzle, row, col, region)) {
+        return -1;
+    }
+
+    // Breadth-first order from the seed, so the moved half is one piece
+    int want = puzzle->region_size[region] / 2;
+    int stamp = ++editor->visit_stamp;
+    int queue_row[MAX_N * MAX_N];
+    int queue_col[MAX_N * MAX_N];
+    int head = 0, tail = 0;
+
+    queue_row[tail] = row;
+    queue_col[tail] = col;
+    editor->visit[row][col] = stamp;
+    tail++;
+    while (head < tail && tail < want) {
+        int r = queue_row[head];
+        int c = queue_col[head];
+        head++;
+        for (int d = 0; d < 4 && tail < want; d++) {
+            int nr = r + DR4[d];
+            int nc = c + DC4[d];
+            if (in_region(puzzle, nr, nc, region) && editor->visit[nr][nc] != stamp) {
+                editor->visit[nr][nc] = stamp;
+                queue_row[tail] = nr;
+                queue_col[tail] = nc;
+                tail++;
+            }
+        }
+    }
+
+    for (int i = 0; i < tail; i++) {
+        transfer_cell(editor, queue_row[i], queue_col[i], target);
+    }
+    invalidate_solutions(puzzle);
+
+    set_connected(editor, target, true);
+    set_connected(editor, region, flood_connected(editor, region));
+    return tail;
+}
+
+bool region_edit_valid(const RegionEditor* editor) {
+    return editor->empty_regions == 0;
+}
+
+bool region_edit_continuous(const RegionEditor* editor) {
+    return editor->split_regions == 0;
+}
@@ -0,0 +1,48 @@
+#ifndef REGIONEDIT_H
+#define REGIONEDIT_H
+
+#include "puzzle.h"
+#include <stdint.h>
+
+/* Lookup tables kept in step with puzzle->regions while it is edited. The
+ * puzzle's region cell lists stay valid after every edit, but cells are kept
+ * in edit order rather than raster order. */
+typedef struct {
+    Puzzle* puzzle;
+    int position[MAX_N][MAX_N];             // Index of each cell in its region's list
+    unsigned char row_cells[MAX_N][MAX_N];  // [region][row]: cells of the region in that row
+    unsigned char col_cells[MAX_N][MAX_N];  // [region][col]: cells of the region in that column
+    uint32_t row_mask[MAX_N];               // Rows each region touches
+    uint32_t col_mask[MAX_N];               // Columns each region touches
+    bool connected[MAX_N];                  // Region is one 4-connected piece (or empty)
+    int split_regions;                      // Regions with more than one piece
+    int empty_regions;                      // Regions without cells
+    int visit[MAX_N][MAX_N];                // Flood-fill stamps
+    int visit_stamp;
+} RegionEditor;
+
+/* Build all tables from puzzle->regions, whose ids must be in 0..n-1, and the
+ * puzzle's region cell lists with them. The puzzle's board must be empty. */
+void region_edit_begin(RegionEditor* editor, Puzzle* puzzle);
+
+/* Move one cell to another region. O(1), plus a flood fill of the regions
+ * involved when a local test cannot rule out a split. */
+bool region_edit_move(RegionEditor* editor, int row, int col, int region);
+
+/* Exchange the regions of two cells */
+bool region_edit_swap(RegionEditor* editor, int row1, int col1, int row2, int col2);
+
+/* Move every cell of absorb into keep, leaving absorb empty. Returns cells moved. */
+int region_edit_merge(RegionEditor* editor, int keep, int absorb);
+
+/* Move half of region's cells, nearest first from (row, col), into the empty
+ * region target. Returns cells moved, or -1 if the arguments are invalid. */
+int region_edit_split(RegionEditor* editor, int region, int row, int col, int target);
+
+/* Every region has at least one cell */
+bool region_edit_valid(const RegionEditor* editor);
+
+/* Every region is a single 4-connected piece */
+bool region_edit_continuous(const RegionEditor* editor);
+
+#endif
@@ -0,0 +1,218 @@
+#include "sampler.h"
+#include <stdlib.h>
+#include <time.h>
+
+#define SAMPLER_EMPTY (-2)
+#define SAMPLER_INITIAL_CAPACITY 1024
+
+static uint64_t next_random(uint64_t* state) {
+    uint64_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    *state = x;
+    return x;
+}
+
+static size_t hash_state(uint32_t cols, uint32_t regions, int prev) {
+    uint64_t h = ((uint64_t)cols << 32 | regions) * 0x9E3779B97F4A7C15ull;
+    h ^= (uint64_t)(prev + 1) * 0xC2B2AE3D27D4EB4Full;
+    return (size_t)(h ^ (h >> 29));
+}
+
+/*
+ * Slot holding the state, or the empty slot where it belongs
+ */
+static SamplerState* find_slot(const Sampler* sampler, uint32_t cols, uint32_t regions, int prev) {
+    size_t mask = sampler->capacity - 1;
+    size_t i = hash_state(cols, regions, prev) & mask;
+
+    while (sampler->table[i].prev != SAMPLER_EMPTY &&
+           (sampler->table[i].cols != cols || sampler->table[i].regions != regions ||
+            sampler->table[i].prev != prev)) {
+        i = (i + 1) & mask;
+    }
+    return &sampler->table[i];
+}
+
+static bool grow_table(Sampler* sampler) {
+    size_t capacity = sampler->capacity ? sampler->capacity * 2 : SAMPLER_INITIAL_CAPACITY;
+    SamplerState* table = (SamplerState*)malloc(sizeof(SamplerState) * capacity);
+    if (!table) {
+        return false;
+    }
+    for (size_t i = 0; i < capacity; i++) {
+        table[i].prev = SAMPLER_EMPTY;
+    }
+
+    SamplerState* old = sampler->table;
+    size_t old_capacity = sampler->capacity;
+    sampler->table = table;
+    sampler->capacity = capacity;
+    for (size_t i = 0; i < old_capacity; i++) {
+        if (old[i].prev != SAMPLER_EMPTY) {
+            *find_slot(sampler, old[i].cols, old[i].regions, old[i].prev) = old[i];
+        }
+    }
+    free(old);
+    return true;
+}
+
+/*
+ * Columns a queen may take in the next row
+ */
+static uint32_t open_columns(const Bitboard* board, uint32_t cols, int prev) {
+    uint32_t avail = board->full & ~cols;
+    if (prev >= 0) {
+        avail &= ~bitboard_touching(1u << prev, board->full);
+    }
+    return avail;
+}
+
+/*
+ * Every region without a queen still has a free column in a row below
+ */
+static bool regions_reachable(const Bitboard* board, uint32_t cols, uint32_t regions, int row) {
+    uint32_t below = board->full & ~((1u << row) - 1);
+    for (uint32_t open = board->full & ~regions; open; open &= open - 1) {
+        int region = bitboard_first(open);
+        uint32_t reached = 0;
+        for (uint32_t rows = board->region_rows[region] & below; rows && !reached; rows &= rows - 1) {
+            reached = board->region_cols[region][bitboard_first(rows)] & ~cols;
+        }
+        if (!reached) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*
+ * Solutions below a state, memoised; 0 once the sampler has overflowed
+ */
+static uint64_t count_state(Sampler* sampler, uint32_t cols, uint32_t regions, int prev) {
+    const Bitboard* board = &sampler->board;
+    int row = bitboard_count(cols);
+    if (row == board->n) {
+        return 1;
+    }
+
+    SamplerState* slot = find_slot(sampler, cols, regions, prev);
+    if (slot->prev != SAMPLER_EMPTY) {
+        return slot->count;
+    }
+
+    uint64_t total = 0;
+    uint32_t avail = regions_reachable(board, cols, regions, row) ? open_columns(board, cols, prev) : 0;
+    while (avail && !sampler->overflow) {
+        int col = bitboard_first(avail);
+        avail &= avail - 1;
+        uint32_t region = 1u << board->region[row][col];
+        if (regions & region) {
+            continue;
+        }
+        uint64_t below = count_state(sampler, cols | (1u << col), regions | region, col);
+        if (__builtin_add_overflow(total, below, &total)) {
+            sampler->overflow = true;
+        }
+    }
+    if (sampler->overflow) {
+        return 0;
+    }
+
+    // The recursion may have grown the table: look the slot up again
+    if ((sampler->states + 1) * 2 > sampler->capacity) {
+        if (sampler->states + 1 > SAMPLER_MAX_STATES || !grow_table(sampler)) {
+            sampler->overflow = true;
+            return 0;
+        }
+    }
+    slot = find_slot(sampler, cols, regions, prev);
+    slot->cols = cols;
+    slot->regions = regions;
+    slot->prev = (int8_t)prev;
+    slot->count = total;
+    sampler->states++;
+    return total;
+}
+
+bool sampler_init(Sampler* sampler, const Puzzle* puzzle, unsigned int seed) {
+    clock_t start = clock();
+
+    bitboard_from_puzzle(&sampler->board, puzzle);
+    sampler->table = NULL;
+    sampler->capacity = 0;
+    sampler->states = 0;
+    sampler->overflow = false;
+    sampler->rng = ((uint64_t)seed << 32) ^ 0x9E3779B97F4A7C15ull;
+
+    if (!grow_table(sampler)) {
+        sampler->overflow = true;
+        return false;
+    }
+    sampler->total = count_state(sampler, 0, 0, -1);
+    sampler->setup_time = (double)(clock() - start) / CLOCKS_PER_SEC;
+    return !sampler->overflow;
+}
+
+void sampler_release(Sampler* sampler) {
+    free(sampler->table);
+    sampler->table = NULL;
+    sampler->capacity = 0;
+}
+
+bool sampler_unrank(const Sampler* sampler, uint64_t index, int* columns) {
+    const Bitboard* board = &sampler->board;
+    if (sampler->overflow || index >= sampler->total) {
+        return false;
+    }
+
+    uint32_t cols = 0, regions = 0;
+    int prev = -1;
+    for (int row = 0; row < board->n; row++) {
+        uint32_t avail = open_columns(board, cols, prev);
+        int chosen = -1;
+        while (avail && chosen < 0) {
+            int col = bitboard_first(avail);
+            avail &= avail - 1;
+            uint32_t region = 1u << board->region[row][col];
+            if (regions & region) {
+                continue;
+            }
+
+            // Every child of a counted state was counted with it
+            uint64_t below = 1;
+            if (row + 1 < board->n) {
+                const SamplerState* child = find_slot(sampler, cols | (1u << col), regions | region, col);
+                below = child->prev == SAMPLER_EMPTY ? 0 : child->count;
+            }
+            if (index < below) {
+                chosen = col;
+                regions |= region;
+            } else {
+                index -= below;
+            }
+        }
+        if (chosen < 0) {
+            return false;
+        }
+        columns[row] = chosen;
+        cols |= 1u << chosen;
+        prev = chosen;
+    }
+    return true;
+}
+
+bool sampler_draw(Sampler* sampler, int* columns) {
+    if (sampler->overflow || sampler->total == 0) {
+        return false;
+    }
+
+    // Reject the top partial range so every index is equally likely
+    uint64_t limit = UINT64_MAX - UINT64_MAX % sampler->total;
+    uint64_t r;
+    do {
+        r = next_random(&sampler->rng);
+    } while (r >= limit);
+    return sampler_unrank(sampler, r % sampler->total, columns);
+}
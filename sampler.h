@@ -0,0 +1,47 @@
+#ifndef SAMPLER_H
+#define SAMPLER_H
+
+#include "bitboard.h"
+#include "puzzle.h"
+#include <stddef.h>
+#include <stdint.h>
+
+#define SAMPLER_MAX_STATES (1 << 22)    // Memo entries before setup gives up (~200 MB)
+
+/* Completions counted from one search state: the columns and regions taken by
+ * the queens of the rows above, and the column of the last of them */
+typedef struct {
+    uint32_t cols;
+    uint32_t regions;
+    int8_t prev;            // Queen column in the row above, -1 on row 0, -2 in an empty slot
+    uint64_t count;
+} SamplerState;
+
+/* Solution counts for every reachable state of one map. Each state is counted
+ * once, so drawing a sample is a weighted descent of n rows. */
+typedef struct Sampler {
+    Bitboard board;
+    SamplerState* table;    // Open-addressing memo
+    size_t capacity;        // Slots, a power of two
+    size_t states;          // Slots in use
+    uint64_t total;         // Solutions of the map
+    bool overflow;          // Too many states, or more than 2^64 solutions
+    uint64_t rng;           // xorshift64 state
+    double setup_time;      // Seconds spent counting
+} Sampler;
+
+/* Count every state's solutions. False (with overflow set) if the memo would
+ * exceed SAMPLER_MAX_STATES or a count outgrow 64 bits; needs only the region ids. */
+bool sampler_init(Sampler* sampler, const Puzzle* puzzle, unsigned int seed);
+
+/* Free the memo */
+void sampler_release(Sampler* sampler);
+
+/* Solution number index (0 <= index < total) in row-major column order,
+ * as one column per row */
+bool sampler_unrank(const Sampler* sampler, uint64_t index, int* columns);
+
+/* One solution drawn uniformly at random; false if there is none */
+bool sampler_draw(Sampler* sampler, int* columns);
+
+#endif
@@ -0,0 +1,462 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "server.h"
+#include "puzzle.h"
+#include "region.h"
+#include "solver.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#define SERVER_BUFFER_SIZE (64 * 1024)
+#define SERVER_MAX_RESPONSE 256
+#define SERVER_MAX_CONNECTIONS 256
+#define SERVER_NODE_LIMIT 200000000L   // Per request, so one huge count cannot pin a worker
+
+/* An open client connection and the unfinished request line it has sent */
+typedef struct {
+    int fd;
+    bool finished;              // Closed by the client or failed; the poll loop closes it
+    char in[SERVER_BUFFER_SIZE];
+    size_t in_length;
+} Connection;
+
+/* Connections passed between the poll loop and the workers. Every open
+ * connection is in at most one queue, so a queue never overflows. */
+typedef struct {
+    Connection* items[SERVER_MAX_CONNECTIONS];
+    int head;
+    int count;
+    pthread_mutex_t lock;
+    pthread_cond_t ready;
+} ConnectionQueue;
+
+/* One worker thread and its preallocated buffers */
+typedef struct {
+    ConnectionQueue* queue;     // Readable connections to serve
+    ConnectionQueue* done;      // Served connections going back to the poll loop
+    int wake_fd;                // Written after each hand-back to wake the poll loop
+    Puzzle* puzzle;
+    atomic_bool cancel;
+    char out[SERVER_BUFFER_SIZE];
+    size_t out_length;
+    pthread_t thread;
+} ServerWorker;
+
+static atomic_int g_stop = 0;
+
+static void handle_stop_signal(int signal_number) {
+    (void)signal_number;
+    atomic_store(&g_stop, 1);
+}
+
+static void close_connection(Connection* connection) {
+    close(connection->fd);
+    free(connection);
+}
+
+static void queue_push(ConnectionQueue* queue, Connection* connection) {
+    pthread_mutex_lock(&queue->lock);
+    queue->items[(queue->head + queue->count) % SERVER_MAX_CONNECTIONS] = connection;
+    queue->count++;
+    pthread_cond_signal(&queue->ready);
+    pthread_mutex_unlock(&queue->lock);
+}
+
+/*
+ * Next connection; with wait, blocks until one arrives or the server is
+ * stopping. NULL when there is none.
+ */
+static Connection* queue_pop(ConnectionQueue* queue, bool wait) {
+    pthread_mutex_lock(&queue->lock);
+    while (wait && queue->count == 0 && !atomic_load(&g_stop)) {
+        pthread_cond_wait(&queue->ready, &queue->lock);
+    }
+    Connection* connection = NULL;
+    if (queue->count > 0) {
+        connection = queue->items[queue->head];
+        queue->head = (queue->head + 1) % SERVER_MAX_CONNECTIONS;
+        queue->count--;
+    }
+    pthread_mutex_unlock(&queue->lock);
+    return connection;
+}
+
+static bool flush_output(ServerWorker* worker, int fd) {
+    size_t sent = 0;
+    while (sent < worker->out_length) {
+        ssize_t written = send(fd, worker->out + sent, worker->out_length - sent, MSG_NOSIGNAL);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        sent += (size_t)written;
+    }
+    worker->out_length = 0;
+    return true;
+}
+
+static void respond(ServerWorker* worker, const char* text) {
+    size_t length = strlen(text);
+    memcpy(worker->out + worker->out_length, text, length);
+    worker->out_length += length;
+}
+
+/*
+ * Append "ok [prefix] c0 c1 ..." from the saved solution
+ */
+static void respond_columns(ServerWorker* worker, const char* prefix) {
+    const Puzzle* puzzle = worker->puzzle;
+    int n = puzzle->n;
+    char* out = worker->out + worker->out_length;
+
+    out += sprintf(out, "ok%s", prefix);
+    for (int row = 0; row < n; row++) {
+        for (int col = 0; col < n; col++) {
+            if (puzzle->solution_board[row][col] >= 0) {
+                out += sprintf(out, " %d", col);
+                break;
+            }
+        }
+    }
+    *out++ = '\n';
+    worker->out_length = (size_t)(out - worker->out);
+}
+
+/*
+ * Stop a uniqueness check at the second solution
+ */
+static void stop_at_second(const Puzzle* puzzle, void* context) {
+    if (puzzle->solution_count >= 2) {
+        atomic_store((atomic_bool*)context, true);
+    }
+}
+
+/*
+ * Parse "N id id ..." into the worker's puzzle
+ */
+static bool load_map(ServerWorker* worker, char* args) {
+    char* end;
+    long n = strtol(args, &end, 10);
+    if (end == args || n < 1 || n > MAX_N) {
+        return false;
+    }
+
+    Puzzle* puzzle = worker->puzzle;
+    puzzle_reset(puzzle, (int)n);
+    for (int row = 0; row < n; row++) {
+        for (int col = 0; col < n; col++) {
+            char* start = end;
+            long region = strtol(start, &end, 10);
+            if (end == start || region < 0 || region >= n) {
+                return false;
+            }
+            puzzle->regions[row][col] = (int)region;
+        }
+    }
+
+    RegionReport report;
+    if (!region_analyze(puzzle, &report)) {
+        return false;
+    }
+    puzzle_build_region_lists(puzzle);
+    return true;
+}
+
+static void handle_line(ServerWorker* worker, char* line) {
+    char* args = line;
+    while (*args && *args != ' ') args++;
+    if (*args) *args++ = '\0';
+
+    if (strcmp(line, "ping") == 0) {
+        respond(worker, "pong\n");
+        return;
+    }
+
+    bool solve = strcmp(line, "solve") == 0;
+    bool count = strcmp(line, "count") == 0;
+    bool unique = strcmp(line, "unique") == 0;
+    if (!solve && !count && !unique) {
+        respond(worker, "error unknown command\n");
+        return;
+    }
+    if (!load_map(worker, args)) {
+        respond(worker, "error bad region map\n");
+        return;
+    }
+
+    SolverConfig config = solver_config_default();
+    config.verbose = false;
+    config.algorithm = SOLVER_ITERATIVE;
+    config.find_all_solutions = count || unique;
+    config.node_limit = SERVER_NODE_LIMIT;
+    config.cancel = &worker->cancel;
+    atomic_store(&worker->cancel, false);
+    if (unique) {
+        config.on_solution = stop_at_second;
+        config.solution_context = &worker->cancel;
+    }
+
+    Puzzle* puzzle = worker->puzzle;
+    solver_solve(puzzle, config);
+    long long solutions = puzzle_get_solution_count(puzzle);
+    bool interrupted = solver_get_stats(puzzle).interrupted;
+
+    if (unique && solutions >= 2) {
+        respond(worker, "ok multiple\n");
+    } else if (interrupted) {
+        respond(worker, "error node limit reached\n");
+    } else if (solutions == 0) {
+        respond(worker, "unsat\n");
+    } else if (count) {
+        char text[32];
+        snprintf(text, sizeof(text), "ok %lld\n", solutions);
+        respond(worker, text);
+    } else {
+        respond_columns(worker, unique ? " unique" : "");
+    }
+}
+
+/*
+ * Read what the connection has sent so far and answer every complete line in
+ * it, pipelined, keeping any partial one. False once the connection is done.
+ */
+static bool serve_batch(ServerWorker* worker, Connection* connection) {
+    ssize_t received;
+    do {
+        received = recv(connection->fd, connection->in + connection->in_length,
+                        SERVER_BUFFER_SIZE - connection->in_length - 1, MSG_DONTWAIT);
+    } while (received < 0 && errno == EINTR);
+    if (received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+        return true;    // Spurious wakeup: nothing to read yet
+    }
+    if (received <= 0) {
+        return false;
+    }
+    connection->in_length += (size_t)received;
+    worker->out_length = 0;
+
+    char* line = connection->in;
+    char* newline;
+    while ((newline = memchr(line, '\n', connection->in + connection->in_length - line))) {
+        *newline = '\0';
+        if (newline > line && newline[-1] == '\r') newline[-1] = '\0';
+        if (*line) {
+            handle_line(worker, line);
+        }
+        line = newline + 1;
+        if (worker->out_length > SERVER_BUFFER_SIZE - SERVER_MAX_RESPONSE &&
+            !flush_output(worker, connection->fd)) {
+            return false;
+        }
+    }
+
+    // Keep the unfinished line; one that fills the buffer can never complete
+    size_t rest = (size_t)(connection->in + connection->in_length - line);
+    if (rest == SERVER_BUFFER_SIZE - 1) {
+        respond(worker, "error request too long\n");
+        rest = 0;
+    }
+    memmove(connection->in, line, rest);
+    connection->in_length = rest;
+
+    return flush_output(worker, connection->fd);
+}
+
+/*
+ * Serve one batch per turn and hand the connection back, so a client that
+ * keeps its connection open cannot hold a worker while others wait
+ */
+static void* worker_thread(void* arg) {
+    ServerWorker* worker = (ServerWorker*)arg;
+    Connection* connection;
+
+    while ((connection = queue_pop(worker->queue, true))) {
+        connection->finished = !serve_batch(worker, connection);
+        queue_push(worker->done, connection);
+        char wake = 0;
+        if (write(worker->wake_fd, &wake, 1) < 0) {
+            // Pipe full: the poll loop has wakeups pending already
+        }
+    }
+    return NULL;
+}
+
+static void queue_init(ConnectionQueue* queue) {
+    queue->head = 0;
+    queue->count = 0;
+    pthread_mutex_init(&queue->lock, NULL);
+    pthread_cond_init(&queue->ready, NULL);
+}
+
+/*
+ * Close whatever is still queued and release the queue
+ */
+static void queue_destroy(ConnectionQueue* queue) {
+    Connection* connection;
+    while ((connection = queue_pop(queue, false))) {
+        close_connection(connection);
+    }
+    pthread_mutex_destroy(&queue->lock);
+    pthread_cond_destroy(&queue->ready);
+}
+
+bool server_run(const char* socket_path, int workers) {
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (strlen(socket_path) >= sizeof(address.sun_path) || workers < 1) {
+        return false;
+    }
+    strcpy(address.sun_path, socket_path);
+
+    int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listener < 0) {
+        return false;
+    }
+    unlink(socket_path);
+    if (bind(listener, (struct sockaddr*)&address, sizeof(address)) != 0 ||
+        listen(listener, SERVER_MAX_CONNECTIONS) != 0) {
+        close(listener);
+        return false;
+    }
+
+    // Workers wake the poll loop through this pipe when they hand a connection back
+    int wake[2];
+    if (pipe(wake) != 0) {
+        close(listener);
+        return false;
+    }
+    fcntl(wake[0], F_SETFL, O_NONBLOCK);
+    fcntl(wake[1], F_SETFL, O_NONBLOCK);
+
+    // No SA_RESTART, so a signal interrupts poll()
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = handle_stop_signal;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGINT, &action, NULL);
+    sigaction(SIGTERM, &action, NULL);
+
+    ConnectionQueue queue, done;
+    queue_init(&queue);
+    queue_init(&done);
+
+    // Workers inherit a blocked mask so the signals land in the poll loop
+    sigset_t stop_signals, previous_mask;
+    sigemptyset(&stop_signals);
+    sigaddset(&stop_signals, SIGINT);
+    sigaddset(&stop_signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &stop_signals, &previous_mask);
+
+    ServerWorker* pool = (ServerWorker*)calloc((size_t)workers, sizeof(ServerWorker));
+    int started = 0;
+    for (int i = 0; pool && i < workers; i++) {
+        pool[i].queue = &queue;
+        pool[i].done = &done;
+        pool[i].wake_fd = wake[1];
+        pool[i].puzzle = puzzle_create(1);
+        atomic_init(&pool[i].cancel, false);
+        if (!pool[i].puzzle ||
+            pthread_create(&pool[i].thread, NULL, worker_thread, &pool[i]) != 0) {
+            puzzle_destroy(pool[i].puzzle);
+            break;
+        }
+        started++;
+    }
+    pthread_sigmask(SIG_SETMASK, &previous_mask, NULL);
+
+    if (started > 0) {
+        fprintf(stderr, "Listening on %s with %d workers\n", socket_path, started);
+    }
+
+    // Idle connections wait here until they have data; the rest are with the workers
+    static Connection* idle[SERVER_MAX_CONNECTIONS];
+    static struct pollfd fds[SERVER_MAX_CONNECTIONS + 2];
+    int idle_count = 0;
+    int open = 0;
+
+    while (started > 0 && !atomic_load(&g_stop)) {
+        fds[0] = (struct pollfd){listener, POLLIN, 0};
+        fds[1] = (struct pollfd){wake[0], POLLIN, 0};
+        for (int i = 0; i < idle_count; i++) {
+            fds[i + 2] = (struct pollfd){idle[i]->fd, POLLIN, 0};
+        }
+        if (poll(fds, (nfds_t)idle_count + 2, -1) < 0) {
+            continue;   // Interrupted: re-check the stop flag
+        }
+
+        // Readable (or hung up) connections go to the workers
+        int kept = 0;
+        for (int i = 0; i < idle_count; i++) {
+            if (fds[i + 2].revents) {
+                queue_push(&queue, idle[i]);
+            } else {
+                idle[kept++] = idle[i];
+            }
+        }
+        idle_count = kept;
+
+        // Take back what the workers have served
+        if (fds[1].revents) {
+            char drain[64];
+            while (read(wake[0], drain, sizeof(drain)) > 0) {
+            }
+        }
+        Connection* connection;
+        while ((connection = queue_pop(&done, false))) {
+            if (connection->finished) {
+                close_connection(connection);
+                open--;
+            } else {
+                idle[idle_count++] = connection;
+            }
+        }
+
+        if (fds[0].revents & POLLIN) {
+            int fd = accept(listener, NULL, NULL);
+            connection = fd >= 0 && open < SERVER_MAX_CONNECTIONS ?
+                         (Connection*)malloc(sizeof(Connection)) : NULL;
+            if (connection) {
+                connection->fd = fd;
+                connection->finished = false;
+                connection->in_length = 0;
+                idle[idle_count++] = connection;
+                open++;
+            } else if (fd >= 0) {
+                close(fd);
+            }
+        }
+    }
+
+    // Wake idle workers; busy ones hand their connection back after the current batch
+    atomic_store(&g_stop, 1);
+    pthread_mutex_lock(&queue.lock);
+    pthread_cond_broadcast(&queue.ready);
+    pthread_mutex_unlock(&queue.lock);
+    for (int i = 0; i < started; i++) {
+        pthread_join(pool[i].thread, NULL);
+        puzzle_destroy(pool[i].puzzle);
+    }
+    for (int i = 0; i < idle_count; i++) {
+        close_connection(idle[i]);
+    }
+
+    free(pool);
+    queue_destroy(&queue);
+    queue_destroy(&done);
+    close(wake[0]);
+    close(wake[1]);
+    close(listener);
+    unlink(socket_path);
+    return started > 0;
+}
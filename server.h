@@ -0,0 +1,22 @@
+#ifndef SERVER_H
+#define SERVER_H
+
+#include <stdbool.h>
+
+/* Serve solve requests on a Unix domain socket until SIGINT or SIGTERM.
+ *
+ * Each of the worker threads owns a preallocated puzzle. Idle connections are
+ * polled; a worker answers the complete requests a connection has sent and
+ * hands it back, so open connections share the workers. Requests on a
+ * connection may be pipelined and are answered in order. One request per line:
+ *
+ *   solve  N id id ... (N*N region ids, row by row)  ->  ok c0 c1 ... | unsat
+ *   count  N id id ...                               ->  ok COUNT
+ *   unique N id id ...                               ->  ok unique c0 c1 ... | ok multiple | unsat
+ *   ping                                             ->  pong
+ *
+ * Malformed requests get "error MESSAGE". Returns false if the socket cannot
+ * be set up. */
+bool server_run(const char* socket_path, int workers);
+
+#endif
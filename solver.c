@@ -1,19 +1,282 @@
 #include "solver.h"
 #include "validator.h"
+#include "backjump.h"
+#include "checkpoint.h"
+#include "iterative.h"
+#include "progress.h"
 #include <stdio.h>
 #include <time.h>
 
-static double g_solve_time = 0.0;
-static int g_nodes_explored = 0;
+// Per-thread so independent solves can run concurrently (see portfolio.c)
+static _Thread_local double g_solve_time = 0.0;
+static _Thread_local SearchCounters g_counters;             // Nodes, depth and path; sampled by --progress
+static _Thread_local unsigned int g_rng_state = 1;
+static _Thread_local bool g_interrupted = false;
+static _Thread_local int g_backjumps = 0;
+static _Thread_local int g_nogood_prunes = 0;
+
+// Warm start: last cell placed in each region (row * MAX_N + col, -1 = none)
+static _Thread_local int g_phase[MAX_N];
+static _Thread_local bool g_use_phase = false;
+static _Thread_local int g_phase_given = 0;
+static _Thread_local int g_phase_kept = 0;
+
+// Checkpoint state: the position being replayed on resume (the branch path is in g_counters)
+#define CHECKPOINT_CHECK_NODES (1 << 20)
+static _Thread_local const Checkpoint* g_resume = NULL;
+static _Thread_local long long g_next_checkpoint_check = 0;
+static _Thread_local clock_t g_solve_start = 0;
+static _Thread_local clock_t g_last_checkpoint = 0;
+static _Thread_local double g_elapsed_before = 0.0;
+
+static inline long long node_count(void) {
+    return atomic_load_explicit(&g_counters.nodes, memory_order_relaxed);
+}
+
+static inline void set_node_count(long long nodes) {
+    atomic_store_explicit(&g_counters.nodes, nodes, memory_order_relaxed);
+}
 
 SolverConfig solver_config_default(void) {
     SolverConfig config;
     config.find_all_solutions = false;
     config.verbose = false;
     config.time_limit = 0.0;
+    config.value_order = VALUE_ORDER_RASTER;
+    config.seed = 1;
+    config.cancel = NULL;
+    config.node_limit = 0;
+    config.algorithm = SOLVER_BACKTRACK;
+    config.checkpoint_path = NULL;
+    config.checkpoint_interval = 60.0;
+    config.resume = NULL;
+    config.progress = NULL;
+    config.on_solution = NULL;
+    config.solution_context = NULL;
+    config.phase = NULL;
     return config;
 }
 
+/*
+ * xorshift32 step for the random value ordering
+ */
+static unsigned int next_random(void) {
+    unsigned int x = g_rng_state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    g_rng_state = x;
+    return x;
+}
+
+/*
+ * Count live candidates of later regions that a queen at (row, col) would remove
+ */
+static int placement_damage(const Puzzle* puzzle, int row, int col, int region) {
+    int n = puzzle->n;
+    int damage = 0;
+    
+    for (int i = 0; i < n; i++) {
+        // Same row
+        if (i != col && puzzle->regions[row][i] > region &&
+            validator_can_place(puzzle, row, i, puzzle->regions[row][i])) {
+            damage++;
+        }
+        // Same column
+        if (i != row && puzzle->regions[i][col] > region &&
+            validator_can_place(puzzle, i, col, puzzle->regions[i][col])) {
+            damage++;
+        }
+    }
+    
+    // Diagonal neighbours (orthogonal ones are already covered by row/column)
+    for (int dr = -1; dr <= 1; dr += 2) {
+        for (int dc = -1; dc <= 1; dc += 2) {
+            int nr = row + dr;
+            int nc = col + dc;
+            if (nr >= 0 && nr < n && nc >= 0 && nc < n &&
+                puzzle->regions[nr][nc] > region &&
+                validator_can_place(puzzle, nr, nc, puzzle->regions[nr][nc])) {
+                damage++;
+            }
+        }
+    }
+    
+    return damage;
+}
+
+/*
+ * Fill order with the indices of the region's cells in the configured order
+ */
+static void order_region_cells(const Puzzle* puzzle, int region, SolverConfig config, int* order) {
+    int count = puzzle->region_size[region];
+    
+    for (int i = 0; i < count; i++) {
+        order[i] = i;
+    }
+    
+    if (config.value_order == VALUE_ORDER_RANDOM) {
+        for (int i = count - 1; i > 0; i--) {
+            int j = (int)(next_random() % (unsigned int)(i + 1));
+            int tmp = order[i];
+            order[i] = order[j];
+            order[j] = tmp;
+        }
+        return;
+    }
+    
+    // VALUE_ORDER_LCV: blocked cells score worst, ties keep raster order
+    int score[MAX_N * MAX_N];
+    for (int i = 0; i < count; i++) {
+        int row = puzzle->region_cells_row[region][i];
+        int col = puzzle->region_cells_col[region][i];
+        score[i] = validator_can_place(puzzle, row, col, region)
+                       ? placement_damage(puzzle, row, col, region)
+                       : MAX_N * MAX_N;
+    }
+    
+    for (int i = 1; i < count; i++) {
+        int idx = order[i];
+        int j = i - 1;
+        while (j >= 0 && score[order[j]] > score[idx]) {
+            order[j + 1] = order[j];
+            j--;
+        }
+        order[j + 1] = idx;
+    }
+}
+
+/*
+ * Move the region's saved-phase cell to the front of the order
+ */
+static void order_phase_first(const Puzzle* puzzle, int region, int* order) {
+    int count = puzzle->region_size[region];
+    int cell = g_phase[region];
+    if (cell < 0) {
+        return;
+    }
+    
+    for (int k = 0; k < count; k++) {
+        int i = order[k];
+        if (puzzle->region_cells_row[region][i] * MAX_N + puzzle->region_cells_col[region][i] == cell) {
+            for (int j = k; j > 0; j--) {
+                order[j] = order[j - 1];
+            }
+            order[0] = i;
+            return;
+        }
+    }
+}
+
+void solver_phase_from_columns(const Puzzle* puzzle, const int* columns, int* phase) {
+    int n = puzzle->n;
+    for (int region = 0; region < MAX_N; region++) {
+        phase[region] = -1;
+    }
+    for (int row = 0; row < n; row++) {
+        int col = columns[row];
+        if (col >= 0 && col < n) {
+            int region = puzzle->regions[row][col];
+            if (region >= 0 && region < n && phase[region] < 0) {
+                phase[region] = row * MAX_N + col;
+            }
+        }
+    }
+}
+
+void solver_save_phase(const Puzzle* puzzle, int* phase) {
+    int columns[MAX_N];
+    for (int row = 0; row < puzzle->n; row++) {
+        columns[row] = -1;
+        for (int col = 0; col < puzzle->n; col++) {
+            if (puzzle->solution_board[row][col] >= 0) {
+                columns[row] = col;
+            }
+        }
+    }
+    solver_phase_from_columns(puzzle, columns, phase);
+}
+
+/*
+ * Save the position of the node being entered at the given level
+ */
+static void save_checkpoint(const Puzzle* puzzle, int region, SolverConfig config) {
+    Checkpoint checkpoint;
+    int path[MAX_N];
+    for (int d = 0; d < region; d++) {
+        path[d] = atomic_load_explicit(&g_counters.branch[d], memory_order_relaxed);
+    }
+    
+    checkpoint_capture(&checkpoint, puzzle, path, region);
+    checkpoint.value_order = config.value_order;
+    checkpoint.find_all_solutions = config.find_all_solutions;
+    checkpoint.nodes_explored = node_count();
+    checkpoint.elapsed = g_elapsed_before + (double)(clock() - g_solve_start) / CLOCKS_PER_SEC;
+    
+    if (!checkpoint_write(config.checkpoint_path, puzzle, &checkpoint) && config.verbose) {
+        fprintf(stderr, "Warning: Failed to write checkpoint %s\n", config.checkpoint_path);
+    }
+}
+
+/*
+ * Restore counters and the saved solution from a checkpoint before resuming
+ */
+static void restore_checkpoint(Puzzle* puzzle, const Checkpoint* checkpoint) {
+    checkpoint_restore_solutions(checkpoint, puzzle);
+    
+    // The replayed path re-counts one node per level
+    set_node_count(checkpoint->nodes_explored - checkpoint->depth);
+    atomic_store_explicit(&g_counters.solutions, puzzle->solution_count, memory_order_relaxed);
+    g_elapsed_before = checkpoint->elapsed;
+    g_resume = checkpoint->depth > 0 ? checkpoint : NULL;
+}
+
+bool solver_path_replays(Puzzle* puzzle, ValueOrder value_order, const int* path, int depth) {
+    if (value_order == VALUE_ORDER_RANDOM) {
+        return false;
+    }
+    
+    SolverConfig config = solver_config_default();
+    config.value_order = value_order;
+    
+    // Place each level's saved cell as solver_backtrack would, then lift them again
+    int order[MAX_N * MAX_N];
+    int placed = 0;
+    bool ok = true;
+    while (ok && placed < depth) {
+        int region = placed;
+        int k = path[region];
+        ok = k >= 0 && k < puzzle->region_size[region];
+        if (ok) {
+            int i = k;
+            if (value_order != VALUE_ORDER_RASTER) {
+                order_region_cells(puzzle, region, config, order);
+                i = order[k];
+            }
+            int row = puzzle->region_cells_row[region][i];
+            int col = puzzle->region_cells_col[region][i];
+            ok = validator_can_place(puzzle, row, col, region);
+            if (ok) {
+                puzzle_set_cell(puzzle, row, col, region);
+                puzzle_mark_row_used(puzzle, row, true);
+                puzzle_mark_col_used(puzzle, col, true);
+                placed++;
+            }
+        }
+    }
+    
+    for (int row = 0; row < puzzle_get_size(puzzle); row++) {
+        for (int col = 0; col < puzzle_get_size(puzzle); col++) {
+            if (puzzle->board[row][col] >= 0) {
+                puzzle_clear_cell(puzzle, row, col);
+                puzzle_mark_row_used(puzzle, row, false);
+                puzzle_mark_col_used(puzzle, col, false);
+            }
+        }
+    }
+    return ok;
+}
+
 void solver_backtrack(Puzzle* puzzle, int region, SolverConfig config) {
     int n = puzzle_get_size(puzzle);
     
@@ -24,6 +287,10 @@ void solver_backtrack(Puzzle* puzzle, int region, SolverConfig config) {
         } else {
             puzzle->solution_count++;
         }
+        atomic_store_explicit(&g_counters.solutions, puzzle->solution_count, memory_order_relaxed);
+        if (config.on_solution) {
+            config.on_solution(puzzle, config.solution_context);
+        }
         return;
     }
     
@@ -32,20 +299,77 @@ void solver_backtrack(Puzzle* puzzle, int region, SolverConfig config) {
         return;
     }
     
+    // Stop when cancelled by another thread or out of node budget
+    if (g_interrupted) {
+        return;
+    }
+    if ((config.cancel && atomic_load_explicit(config.cancel, memory_order_relaxed)) ||
+        (config.node_limit > 0 && node_count() >= config.node_limit)) {
+        g_interrupted = true;
+        return;
+    }
+    
+    // Periodic checkpoint of the node being entered
+    if (config.checkpoint_path && node_count() >= g_next_checkpoint_check) {
+        g_next_checkpoint_check = node_count() + CHECKPOINT_CHECK_NODES;
+        clock_t now = clock();
+        if ((double)(now - g_last_checkpoint) / CLOCKS_PER_SEC >= config.checkpoint_interval) {
+            save_checkpoint(puzzle, region, config);
+            g_last_checkpoint = now;
+        }
+    }
+    
+    atomic_store_explicit(&g_counters.depth, region, memory_order_relaxed);
+    
+    // On resume, start each level of the saved path at its saved position
+    int start = 0;
+    if (g_resume) {
+        if (region < g_resume->depth) {
+            start = g_resume->path[region];
+        } else {
+            g_resume = NULL;
+        }
+    }
+    
     // OPTIMIZATION: Only try cells that belong to this region
     int region_cell_count = puzzle->region_size[region];
     
-    for (int i = 0; i < region_cell_count; i++) {
+    int order_buffer[MAX_N * MAX_N];
+    const int* order = NULL;
+    if (config.value_order != VALUE_ORDER_RASTER) {
+        order_region_cells(puzzle, region, config, order_buffer);
+        order = order_buffer;
+    }
+    if (g_use_phase) {
+        if (!order) {
+            for (int k = 0; k < region_cell_count; k++) {
+                order_buffer[k] = k;
+            }
+            order = order_buffer;
+        }
+        order_phase_first(puzzle, region, order_buffer);
+    }
+    
+    if (g_resume && start >= region_cell_count) {
+        g_resume = NULL;
+        g_interrupted = true;
+        return;
+    }
+    
+    for (int k = start; k < region_cell_count; k++) {
+        int i = order ? order[k] : k;
         int row = puzzle->region_cells_row[region][i];
         int col = puzzle->region_cells_col[region][i];
         
-        g_nodes_explored++;
+        set_node_count(node_count() + 1);
         
         if (validator_can_place(puzzle, row, col, region)) {
             // Place queen
             puzzle_set_cell(puzzle, row, col, region);
             puzzle_mark_row_used(puzzle, row, true);
             puzzle_mark_col_used(puzzle, col, true);
+            atomic_store_explicit(&g_counters.branch[region], k, memory_order_relaxed);
+            g_phase[region] = row * MAX_N + col;
             
             // Recurse to next region
             solver_backtrack(puzzle, region + 1, config);
@@ -56,27 +380,87 @@ void solver_backtrack(Puzzle* puzzle, int region, SolverConfig config) {
             puzzle_mark_col_used(puzzle, col, false);
             
             // Early exit if found and don't need all
-            if (!config.find_all_solutions && puzzle_has_solution(puzzle)) {
+            if ((!config.find_all_solutions && puzzle_has_solution(puzzle)) || g_interrupted) {
                 return;
             }
+        } else if (g_resume) {
+            // Saved path does not fit this map: stop rather than count twice
+            g_resume = NULL;
+            g_interrupted = true;
+            return;
         }
     }
 }
 
 bool solver_solve(Puzzle* puzzle, SolverConfig config) {
     clock_t start = clock();
-    g_nodes_explored = 0;
+    progress_counters_reset(&g_counters, 0);
+    g_interrupted = false;
+    g_backjumps = 0;
+    g_nogood_prunes = 0;
+    g_rng_state = config.seed ? config.seed : 1;
+    g_solve_start = start;
+    g_last_checkpoint = start;
+    g_next_checkpoint_check = 0;
+    g_elapsed_before = 0.0;
+    g_resume = NULL;
     
-    solver_backtrack(puzzle, 0, config);
+    // Pick the engine first; the warm-start phase only applies to the backtracker
+    bool iterative = config.algorithm == SOLVER_ITERATIVE && config.value_order == VALUE_ORDER_RASTER;
+    bool backjump = config.algorithm == SOLVER_BACKJUMP;
+    g_use_phase = config.phase && !iterative && !backjump && !config.checkpoint_path && !config.resume;
+    g_phase_given = 0;
+    g_phase_kept = 0;
+    for (int region = 0; region < MAX_N; region++) {
+        g_phase[region] = g_use_phase ? config.phase[region] : -1;
+        g_phase_given += g_phase[region] >= 0 && region < puzzle_get_size(puzzle);
+    }
+    
+    if (iterative) {
+        IterativeStats stats;
+        iterative_search(puzzle, config, &stats);
+        set_node_count(stats.nodes_explored);
+        g_interrupted = stats.interrupted;
+        g_elapsed_before = config.resume ? config.resume->elapsed : 0.0;
+    } else if (backjump) {
+        BackjumpStats stats;
+        backjump_search(puzzle, config, &stats);
+        set_node_count(stats.nodes_explored);
+        g_interrupted = stats.interrupted;
+        g_backjumps = stats.backjumps;
+        g_nogood_prunes = stats.nogood_prunes;
+    } else {
+        if (config.resume) {
+            restore_checkpoint(puzzle, config.resume);
+        }
+        progress_attach(config.progress, puzzle, &g_counters);
+        solver_backtrack(puzzle, 0, config);
+        progress_detach(config.progress);
+    }
     
     clock_t end = clock();
-    g_solve_time = (double)(end - start) / CLOCKS_PER_SEC;
+    g_solve_time = g_elapsed_before + (double)(end - start) / CLOCKS_PER_SEC;
+    
+    // How much of the prior solution survived
+    if (g_use_phase && puzzle_has_solution(puzzle)) {
+        for (int region = 0; region < puzzle_get_size(puzzle); region++) {
+            int cell = config.phase[region];
+            g_phase_kept += cell >= 0 &&
+                            puzzle->solution_board[cell / MAX_N][cell % MAX_N] == region;
+        }
+    }
     
     if (config.verbose) {
         printf("Solved %dx%d board in %.6f seconds\n", 
                puzzle_get_size(puzzle), puzzle_get_size(puzzle), g_solve_time);
-        printf("Explored %d nodes\n", g_nodes_explored);
-        printf("Found %d solution(s)\n", puzzle_get_solution_count(puzzle));
+        printf("Explored %lld nodes\n", node_count());
+        if (config.algorithm == SOLVER_BACKJUMP) {
+            printf("Backjumps: %d, nogood prunes: %d\n", g_backjumps, g_nogood_prunes);
+        }
+        if (g_use_phase) {
+            printf("Warm start kept %d of %d preferred cells\n", g_phase_kept, g_phase_given);
+        }
+        printf("Found %lld solution(s)\n", puzzle_get_solution_count(puzzle));
     }
     
     return puzzle_has_solution(puzzle);
@@ -86,6 +470,11 @@ SolverStats solver_get_stats(const Puzzle* puzzle) {
     SolverStats stats;
     stats.solve_time = g_solve_time;
     stats.solutions_found = puzzle_get_solution_count(puzzle);
-    stats.nodes_explored = g_nodes_explored;
+    stats.nodes_explored = node_count();
+    stats.interrupted = g_interrupted;
+    stats.backjumps = g_backjumps;
+    stats.nogood_prunes = g_nogood_prunes;
+    stats.phase_given = g_phase_given;
+    stats.phase_kept = g_phase_kept;
     return stats;
 }
\ No newline at end of file
@@ -2,12 +2,46 @@
 #define SOLVER_H
 
 #include "puzzle.h"
+#include <stdatomic.h>
+
+/* Order in which the cells of a region are tried */
+typedef enum {
+    VALUE_ORDER_RASTER,     // Row-major order from puzzle_build_region_lists
+    VALUE_ORDER_LCV,        // Least-constraining cell first
+    VALUE_ORDER_RANDOM      // Seeded random shuffle
+} ValueOrder;
+
+struct Checkpoint;
+struct SolverProgress;
+
+/* Search algorithm used by solver_solve */
+typedef enum {
+    SOLVER_BACKTRACK,           // Chronological backtracking (solver_backtrack)
+    SOLVER_BACKJUMP,            // Conflict-directed backjumping with nogoods (backjump.c)
+    SOLVER_ITERATIVE            // Explicit-stack backtracking, raster order only (iterative.c)
+} SolverAlgorithm;
 
 /* Solver configuration */
 typedef struct {
     bool find_all_solutions;    // If true, find all solutions
     bool verbose;               // Print progress
     double time_limit;          // Maximum time in seconds (0 = no limit)
+    ValueOrder value_order;     // Cell ordering inside each region
+    unsigned int seed;          // Seed for VALUE_ORDER_RANDOM
+    atomic_bool* cancel;        // Stop as soon as this becomes true (NULL = never)
+    long node_limit;            // Give up after this many nodes (0 = no limit)
+    SolverAlgorithm algorithm;  // Search algorithm
+    const char* checkpoint_path;    // Periodically save the search position here (NULL = off)
+    double checkpoint_interval;     // Seconds between checkpoints
+    const struct Checkpoint* resume; // Continue from this position (NULL = start fresh)
+    struct SolverProgress* progress; // Live counters for a progress reporter (NULL = off)
+    void (*on_solution)(const Puzzle* puzzle, void* context); // Called with each solution on the board (NULL = off)
+    void* solution_context;     // Passed to on_solution
+    const int* phase;           // Warm start: preferred cell per region, row * MAX_N + col or -1
+                                // (NULL = off). Tried first, and each region's last placement is
+                                // tried first after that. Backtracker only: ignored, with
+                                // phase_given 0, under SOLVER_BACKJUMP, SOLVER_ITERATIVE,
+                                // checkpoints or resume.
 } SolverConfig;
 
 /* Create default solver configuration */
@@ -16,14 +50,30 @@ SolverConfig solver_config_default(void);
 /* Main solving function */
 bool solver_solve(Puzzle* puzzle, SolverConfig config);
 
+/* Warm-start phase from a prior solution given as a queen column per row (-1 =
+ * none): each queen becomes the preferred cell of whatever region now holds it */
+void solver_phase_from_columns(const Puzzle* puzzle, const int* columns, int* phase);
+
+/* Phase of the puzzle's saved solution, to warm-start the next solve */
+void solver_save_phase(const Puzzle* puzzle, int* phase);
+
+/* Whether a saved branch path (cell order index per level) places a legal queen
+ * at every level when replayed on the puzzle's empty board in value_order */
+bool solver_path_replays(Puzzle* puzzle, ValueOrder value_order, const int* path, int depth);
+
 /* Backtracking helper (internal) */
 void solver_backtrack(Puzzle* puzzle, int region, SolverConfig config);
 
 /* Get solving statistics */
 typedef struct {
     double solve_time;
-    int solutions_found;
-    int nodes_explored;
+    long long solutions_found;
+    long long nodes_explored;
+    bool interrupted;           // Search stopped by cancel flag or node limit
+    int backjumps;              // SOLVER_BACKJUMP: non-chronological jumps taken
+    int nogood_prunes;          // SOLVER_BACKJUMP: cells rejected by recorded nogoods
+    int phase_given;            // Warm start: regions with a preferred cell
+    int phase_kept;             // Warm start: of those, regions solved on that cell
 } SolverStats;
 
 SolverStats solver_get_stats(const Puzzle* puzzle);
@@ -1,4 +1,6 @@
 #include "validator.h"
+#include "region.h"
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 
@@ -149,13 +151,119 @@ bool validator_check_diagonals(const Puzzle* puzzle) {
     return true;
 }
 
+VerifyResult validator_verify_columns(const Puzzle* puzzle, const int* cols) {
+    int n = puzzle_get_size(puzzle);
+    uint32_t cols_seen = 0, regions_seen = 0;
+    uint32_t col_clash = 0, region_clash = 0, adjacent = 0;
+    int prev = -2;
+    
+    // Accumulate every violation and decide once at the end
+    for (int row = 0; row < n; row++) {
+        int col = cols[row];
+        if ((unsigned)col >= (unsigned)n) {
+            return VERIFY_BAD_COLUMN;
+        }
+        
+        uint32_t col_bit = 1u << col;
+        uint32_t region_bit = 1u << puzzle->regions[row][col];
+        col_clash |= cols_seen & col_bit;
+        region_clash |= regions_seen & region_bit;
+        cols_seen |= col_bit;
+        regions_seen |= region_bit;
+        
+        // Distinct columns only touch diagonally when they differ by one
+        adjacent |= (uint32_t)(abs(col - prev) <= 1);
+        prev = col;
+    }
+    
+    if (col_clash) return VERIFY_COLUMN_CLASH;
+    if (region_clash) return VERIFY_REGION_CLASH;
+    if (adjacent) return VERIFY_ADJACENT;
+    return VERIFY_OK;
+}
+
+const char* validator_result_message(VerifyResult result) {
+    switch (result) {
+        case VERIFY_OK: return "valid";
+        case VERIFY_BAD_COLUMN: return "column out of range";
+        case VERIFY_COLUMN_CLASH: return "two queens share a column";
+        case VERIFY_REGION_CLASH: return "two queens share a region";
+        case VERIFY_ADJACENT: return "queens diagonally adjacent";
+    }
+    return "unknown";
+}
+
+bool validator_verify_stream(FILE* in, FILE* failures, VerifyTotals* totals) {
+    totals->checked = 0;
+    totals->valid = 0;
+    totals->invalid = 0;
+    totals->malformed = false;
+    
+    Puzzle* puzzle = puzzle_create(1);
+    if (!puzzle) {
+        return false;
+    }
+    
+    int cols[MAX_N];
+    int c;
+    while ((c = fgetc(in)) != EOF) {
+        if (c == ' ' || c == '\t' || c == '\n' || c == '\r') continue;
+        ungetc(c, in);
+        
+        bool ok = region_read_map(in, puzzle);
+        int n = puzzle_get_size(puzzle);
+        for (int row = 0; ok && row < n; row++) {
+            ok = fscanf(in, "%d", &cols[row]) == 1;
+        }
+        if (!ok) {
+            totals->malformed = true;
+            break;
+        }
+        
+        VerifyResult result = validator_verify_columns(puzzle, cols);
+        totals->checked++;
+        if (result == VERIFY_OK) {
+            totals->valid++;
+        } else {
+            totals->invalid++;
+            if (failures) {
+                fprintf(failures, "record %ld: %s\n", totals->checked,
+                        validator_result_message(result));
+            }
+        }
+    }
+    
+    puzzle_destroy(puzzle);
+    return !totals->malformed;
+}
+
 bool validator_verify_solution(const Puzzle* puzzle) {
     if (!puzzle_has_solution(puzzle)) {
         return false;
     }
     
-    return validator_check_rows(puzzle) &&
-           validator_check_columns(puzzle) &&
-           validator_check_regions(puzzle) &&
-           validator_check_diagonals(puzzle);
-}
\ No newline at end of file
+    int n = puzzle_get_size(puzzle);
+    int cols[MAX_N];
+    
+    // Reduce the saved board to one column per row
+    for (int row = 0; row < n; row++) {
+        int queens = 0;
+        for (int col = 0; col < n; col++) {
+            if (puzzle->solution_board[row][col] >= 0) {
+                cols[row] = col;
+                queens++;
+            }
+        }
+        if (queens != 1) {
+            printf("✗ Row %d has %d queens (expected 1)\n", row, queens);
+            return false;
+        }
+    }
+    
+    VerifyResult result = validator_verify_columns(puzzle, cols);
+    if (result != VERIFY_OK) {
+        printf("✗ Solution rejected: %s\n", validator_result_message(result));
+        return false;
+    }
+    return true;
+}
@@ -2,6 +2,24 @@
 #define VALIDATOR_H
 
 #include "puzzle.h"
+#include <stdio.h>
+
+/* Outcome of checking a solution given as one column per row */
+typedef enum {
+    VERIFY_OK,
+    VERIFY_BAD_COLUMN,      // A row's column is outside the board
+    VERIFY_COLUMN_CLASH,    // Two queens share a column
+    VERIFY_REGION_CLASH,    // Two queens share a region
+    VERIFY_ADJACENT         // Queens in consecutive rows touch
+} VerifyResult;
+
+/* Totals of a --verify batch */
+typedef struct {
+    long checked;
+    long valid;
+    long invalid;
+    bool malformed;         // Stopped at a record that could not be parsed
+} VerifyTotals;
 
 /* Check if two positions are diagonally adjacent */
 bool validator_is_diagonally_adjacent(const Puzzle* puzzle, int row1, int col1, int row2, int col2);
@@ -12,6 +30,19 @@ bool validator_has_adjacent_queen(const Puzzle* puzzle, int row, int col);
 /* Check if placing a queen at (row, col) is valid */
 bool validator_can_place(const Puzzle* puzzle, int row, int col, int region);
 
+/* Check every constraint in one pass with column and region bitmasks; cols[row]
+ * is the queen's column in that row, so each row holds exactly one queen by
+ * construction. Prints nothing. */
+VerifyResult validator_verify_columns(const Puzzle* puzzle, const int* cols);
+
+/* Human-readable reason for a result */
+const char* validator_result_message(VerifyResult result);
+
+/* Check a stream of records, each a region map in region_write_map format
+ * followed by n columns, until end of file. Rejected records are listed on
+ * failures when it is not NULL. Returns false if a record is malformed. */
+bool validator_verify_stream(FILE* in, FILE* failures, VerifyTotals* totals);
+
 /* Verify the complete solution satisfies all constraints */
 bool validator_verify_solution(const Puzzle* puzzle);
 